@@ -0,0 +1,412 @@
+#include "BulkValidator.h"
+#include "core/Bitops.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NQueens {
+namespace Cli {
+
+namespace {
+
+const uint32_t NO_LINE = UINT32_MAX;
+const int SHARD_BITS = 6;
+
+// 按行号排序的记录位置：块编号在高 32 位，块内行号在低 32 位
+uint64_t positionOf(uint64_t block, uint32_t line) {
+    return (block << 32) | line;
+}
+
+// 每列 5 位，31 列共 155 位
+struct BoardKey {
+    uint64_t words[3] = {};
+
+    bool operator==(const BoardKey &other) const {
+        return words[0] == other.words[0] && words[1] == other.words[1] && words[2] == other.words[2];
+    }
+};
+
+struct BoardKeyHash {
+    size_t operator()(const BoardKey &key) const { return (size_t)mix(key); }
+
+    static uint64_t mix(const BoardKey &key) {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (uint64_t w : key.words) {
+            h ^= w + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+            h *= 0xBF58476D1CE4E5B9ull;
+        }
+        return h ^ (h >> 31);
+    }
+};
+
+BoardKey keyOf(const int *queens, int n) {
+    BoardKey key;
+    for (int r = 0; r < n; ++r) {
+        int bit = r * 5;
+        key.words[bit / 64] |= uint64_t(queens[r]) << (bit % 64);
+        if (bit % 64 > 59) key.words[bit / 64 + 1] |= uint64_t(queens[r]) >> (64 - bit % 64);
+    }
+    return key;
+}
+
+std::string textOf(const BoardKey &key, int n) {
+    std::string text;
+    for (int r = 0; r < n; ++r) {
+        int bit = r * 5;
+        uint64_t v = key.words[bit / 64] >> (bit % 64);
+        if (bit % 64 > 59) v |= key.words[bit / 64 + 1] << (64 - bit % 64);
+        if (r) text += ' ';
+        text += std::to_string(v & 31);
+    }
+    return text;
+}
+
+struct Occurrence {
+    uint64_t first;
+    uint64_t second;  // 第二次出现；只出现一次时为 UINT64_MAX
+    uint64_t count;
+};
+
+struct DuplicateShard {
+    std::mutex mutex;
+    std::unordered_map<BoardKey, Occurrence, BoardKeyHash> seen;
+};
+
+struct BlockResult {
+    uint64_t lines = 0;
+    uint64_t records = 0;
+    uint64_t invalid = 0;
+    uint64_t nonCanonical = 0;
+    uint32_t firstInvalid = NO_LINE;
+    std::string invalidReason;
+    std::string invalidText;
+    uint32_t firstNonCanonical = NO_LINE;
+    std::string nonCanonicalText;
+};
+
+// 解析一行中的列号；text 为空白分隔，csv 首项为 n，json 为 {"n":N,"queens":[...]}。
+// 列数超过 MAX_BOARD_SIZE 时返回 false，count 仍为实际列数
+bool parseRecord(const char *p, const char *end, OutputFormat format, int *out, int &count, std::string &reason) {
+    count = 0;
+    int declared = -1;
+    char separator = format == OutputFormat::Text ? ' ' : ',';
+    if (format == OutputFormat::Json) {
+        const char *n = std::search(p, end, "\"n\":", "\"n\":" + 4);
+        const char *queens = std::search(p, end, "\"queens\":[", "\"queens\":[" + 10);
+        const char *close = queens == end ? end : std::find(queens, end, ']');
+        if (n == end || queens == end || close == end) {
+            reason = "不是 {\"n\":N,\"queens\":[...]} 格式";
+            return false;
+        }
+        declared = 0;
+        for (const char *q = n + 4; q < end && *q >= '0' && *q <= '9'; ++q) declared = declared * 10 + (*q - '0');
+        p = queens + 10;
+        end = close;
+    }
+
+    bool first = true;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        if (p == end) break;
+        if (!first) {
+            if (separator != ' ') {
+                if (*p != separator) {
+                    reason = "分隔符错误";
+                    return false;
+                }
+                ++p;
+                while (p < end && (*p == ' ' || *p == '\t')) ++p;
+            }
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            reason = "包含非数字内容";
+            return false;
+        }
+        int v = 0;
+        while (p < end && *p >= '0' && *p <= '9' && v < 1000) v = v * 10 + (*p++ - '0');
+        if (format == OutputFormat::Csv && first) {
+            declared = v;
+        } else {
+            // 超出上限的列只计数不保存，调用方据此区分“列数过多”与格式错误
+            if (count < Core::MAX_BOARD_SIZE) out[count] = v;
+            ++count;
+        }
+        first = false;
+    }
+    if (count > Core::MAX_BOARD_SIZE) {
+        reason = "列数 " + std::to_string(count) + " 超过上限 " + std::to_string(Core::MAX_BOARD_SIZE);
+        return false;
+    }
+    if (declared >= 0 && declared != count) {
+        reason = "声明的 n 与列数不符";
+        return false;
+    }
+    return true;
+}
+
+// 列与两组对角线各一个 64 位掩码，n <= 31 时对角线编号不超过 61
+bool checkQueens(const int *queens, int n, std::string &reason) {
+    uint64_t cols = 0, down = 0, up = 0;
+    for (int r = 0; r < n; ++r) {
+        int c = queens[r];
+        if (c < 0 || c >= n) {
+            reason = "第 " + std::to_string(r) + " 行列号越界";
+            return false;
+        }
+        uint64_t colBit = 1ull << c, downBit = 1ull << (r + c), upBit = 1ull << (r - c + n - 1);
+        if ((cols & colBit) | (down & downBit) | (up & upBit)) {
+            reason = "第 " + std::to_string(r) + " 行" + ((cols & colBit) ? "与前面的行同列" : "与前面的行在同一对角线");
+            return false;
+        }
+        cols |= colBit;
+        down |= downBit;
+        up |= upBit;
+    }
+    return true;
+}
+
+// 排列的 8 种对称变换为 X(p(Y(r)))：p 取自身或逆排列，X、Y 取恒等或翻转；canonical 即字典序最小
+bool isCanonical(const int *queens, int n) {
+    int inverse[Core::MAX_BOARD_SIZE];
+    for (int r = 0; r < n; ++r) inverse[queens[r]] = r;
+    for (int variant = 1; variant < 8; ++variant) {
+        const int *p = (variant & 4) ? inverse : queens;
+        bool flipRows = variant & 1, flipCols = variant & 2;
+        for (int r = 0; r < n; ++r) {
+            int v = p[flipRows ? n - 1 - r : r];
+            if (flipCols) v = n - 1 - v;
+            if (v < queens[r]) return false;
+            if (v > queens[r]) break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const BadRecord *ValidationReport::firstBad() const {
+    const BadRecord *best = nullptr;
+    for (const BadRecord *b : {&firstInvalid, &firstNonCanonical, &firstDuplicate})
+        if (b->line && (!best || b->line < best->line)) best = b;
+    return best;
+}
+
+ValidationReport validateSolutions(std::FILE *in, const ValidateOptions &options) {
+    if (options.n < 0 || options.n > Core::MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(options.n));
+    const size_t blockSize = std::max<size_t>(options.blockSize, 4096);
+    const int threads = std::max(1, options.threads);
+
+    ValidationReport report;
+    int n = options.n;
+    std::deque<BlockResult> results;  // 追加不会移动已有元素，工作线程持有的引用一直有效
+    std::vector<DuplicateShard> shards(options.duplicates ? (1u << SHARD_BITS) : 0);
+
+    auto processBlock = [&](uint64_t id, const std::vector<char> &data, BlockResult &result) {
+        int queens[Core::MAX_BOARD_SIZE + 1];
+        std::vector<std::vector<std::pair<BoardKey, uint64_t>>> pending(shards.size());
+        std::string reason;
+        const char *p = data.data();
+        const char *end = p + data.size();
+        uint32_t line = 0;
+        for (; p < end; ++line) {
+            const char *eol = std::find(p, end, '\n');
+            const char *stop = eol;
+            if (stop > p && stop[-1] == '\r') --stop;
+            const char *lineBegin = p;
+            p = eol == end ? end : eol + 1;
+            result.lines++;
+            if (stop == lineBegin) continue;
+
+            result.records++;
+            int count = 0;
+            bool valid = parseRecord(lineBegin, stop, options.format, queens, count, reason);
+            if (valid && count != n) {
+                valid = false;
+                reason = "列数 " + std::to_string(count) + " 与 N=" + std::to_string(n) + " 不符";
+            }
+            if (valid) valid = checkQueens(queens, n, reason);
+            if (!valid) {
+                if (result.invalid++ == 0) {
+                    result.firstInvalid = line;
+                    result.invalidReason = reason;
+                    result.invalidText.assign(lineBegin, stop);
+                }
+                continue;
+            }
+            if (options.canonical && !isCanonical(queens, n)) {
+                if (result.nonCanonical++ == 0) {
+                    result.firstNonCanonical = line;
+                    result.nonCanonicalText.assign(lineBegin, stop);
+                }
+            }
+            if (!shards.empty()) {
+                BoardKey key = keyOf(queens, n);
+                pending[BoardKeyHash::mix(key) >> (64 - SHARD_BITS)].push_back({key, positionOf(id, line)});
+            }
+        }
+        // 每个分片只加一次锁
+        for (size_t s = 0; s < pending.size(); ++s) {
+            if (pending[s].empty()) continue;
+            std::lock_guard<std::mutex> lock(shards[s].mutex);
+            for (const auto &[key, pos] : pending[s]) {
+                auto [it, inserted] = shards[s].seen.try_emplace(key, Occurrence{pos, UINT64_MAX, 1});
+                if (inserted) continue;
+                Occurrence &o = it->second;
+                o.count++;
+                if (pos < o.first) {
+                    o.second = o.first;
+                    o.first = pos;
+                } else if (pos < o.second) {
+                    o.second = pos;
+                }
+            }
+        }
+    };
+
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable slotFree;
+    std::deque<std::pair<uint64_t, std::vector<char>>> jobs;
+    bool finished = false;
+
+    std::vector<std::thread> pool;
+    auto startWorkers = [&]() {
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&]() {
+                for (;;) {
+                    std::pair<uint64_t, std::vector<char>> job;
+                    BlockResult *result;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        jobReady.wait(lock, [&]() { return finished || !jobs.empty(); });
+                        if (jobs.empty()) return;
+                        job = std::move(jobs.front());
+                        jobs.pop_front();
+                        result = &results[job.first];
+                    }
+                    slotFree.notify_one();
+                    processBlock(job.first, job.second, *result);
+                }
+            });
+        }
+    };
+
+    // 第一条能解析的记录决定 N
+    auto detectSize = [&](const std::vector<char> &data) {
+        int queens[Core::MAX_BOARD_SIZE + 1];
+        std::string reason;
+        const char *p = data.data();
+        const char *end = p + data.size();
+        while (p < end && n == 0) {
+            const char *eol = std::find(p, end, '\n');
+            int count = 0;
+            bool parsed = parseRecord(p, eol > p && eol[-1] == '\r' ? eol - 1 : eol, options.format, queens, count, reason);
+            if ((parsed && count > 0) || count > Core::MAX_BOARD_SIZE) n = count;
+            p = eol == end ? end : eol + 1;
+        }
+    };
+
+    std::vector<char> carry;
+    uint64_t nextId = 0;
+    bool eof = false;
+    try {
+        while (!eof) {
+            std::vector<char> data(std::move(carry));
+            carry.clear();
+            size_t old = data.size();
+            data.resize(old + blockSize);
+            size_t got = std::fread(data.data() + old, 1, blockSize, in);
+            data.resize(old + got);
+            report.bytes += got;
+            if (got < blockSize) {
+                if (std::ferror(in)) throw std::runtime_error("读取输入失败");
+                eof = true;
+            }
+            // 在最后一个换行处截断；整块都没有换行时继续读
+            if (!eof) {
+                auto lastNewline = std::find(data.rbegin(), data.rend(), '\n');
+                if (lastNewline == data.rend()) {
+                    carry = std::move(data);
+                    continue;
+                }
+                size_t cut = data.rend() - lastNewline;
+                carry.assign(data.begin() + cut, data.end());
+                data.resize(cut);
+            }
+            if (data.empty()) continue;
+
+            if (pool.empty()) {
+                detectSize(data);
+                if (n == 0) throw std::runtime_error("第一块中没有可解析的记录，请用 -n 指定棋盘大小");
+                if (n > Core::MAX_BOARD_SIZE)
+                    throw std::runtime_error("记录有 " + std::to_string(n) + " 列，超过支持的最大 N=" + std::to_string(Core::MAX_BOARD_SIZE));
+                startWorkers();
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            slotFree.wait(lock, [&]() { return jobs.size() < 2 * (size_t)threads; });
+            results.emplace_back();
+            jobs.emplace_back(nextId++, std::move(data));
+            lock.unlock();
+            jobReady.notify_one();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            jobs.clear();
+        }
+        jobReady.notify_all();
+        for (auto &th : pool) th.join();
+        throw;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    jobReady.notify_all();
+    for (auto &th : pool) th.join();
+
+    // 各块的行数前缀和换算为全局行号
+    report.n = n;
+    std::vector<uint64_t> firstLine(results.size());
+    uint64_t lines = 0;
+    for (size_t b = 0; b < results.size(); ++b) {
+        const BlockResult &r = results[b];
+        firstLine[b] = lines;
+        lines += r.lines;
+        report.records += r.records;
+        report.invalid += r.invalid;
+        report.nonCanonical += r.nonCanonical;
+        if (r.firstInvalid != NO_LINE && !report.firstInvalid.line)
+            report.firstInvalid = {firstLine[b] + r.firstInvalid + 1, r.invalidReason, r.invalidText};
+        if (r.firstNonCanonical != NO_LINE && !report.firstNonCanonical.line)
+            report.firstNonCanonical = {firstLine[b] + r.firstNonCanonical + 1, "不是 8 种对称变换中字典序最小的形式", r.nonCanonicalText};
+    }
+    auto lineOf = [&](uint64_t pos) { return firstLine[pos >> 32] + (pos & 0xFFFFFFFFu) + 1; };
+
+    const Occurrence *firstDuplicate = nullptr;
+    const BoardKey *duplicateKey = nullptr;
+    for (const DuplicateShard &shard : shards) {
+        for (const auto &[key, o] : shard.seen) {
+            if (o.count < 2) continue;
+            report.duplicates += o.count - 1;
+            if (!firstDuplicate || o.second < firstDuplicate->second) {
+                firstDuplicate = &o;
+                duplicateKey = &key;
+            }
+        }
+    }
+    if (firstDuplicate)
+        report.firstDuplicate = {lineOf(firstDuplicate->second), "与第 " + std::to_string(lineOf(firstDuplicate->first)) + " 行相同",
+                                 textOf(*duplicateKey, n)};
+    return report;
+}
+
+} // namespace Cli
+} // namespace NQueens
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "cli/OutputWriter.h"
+
+namespace NQueens {
+	namespace Cli {
+
+		struct ValidateOptions {
+			OutputFormat format = OutputFormat::Text;  // 与 enum 的 --format 相同
+			int n = 0;                    // 0 表示以第一条记录的长度为准
+			int threads = 1;
+			bool canonical = false;       // 要求每个解是 8 种对称变换中字典序最小的一个
+			bool duplicates = false;      // 检查重复记录
+			size_t blockSize = size_t(8) << 20;
+		};
+
+		// 某一类问题的第一条记录；line 为 0 表示没有
+		struct BadRecord {
+			uint64_t line = 0;
+			std::string reason;
+			std::string text;
+		};
+
+		struct ValidationReport {
+			int n = 0;
+			uint64_t bytes = 0;
+			uint64_t records = 0;
+			uint64_t invalid = 0;        // 格式错误、越界、同列或同对角线
+			uint64_t nonCanonical = 0;
+			uint64_t duplicates = 0;     // 与前面某条记录完全相同的记录数
+			BadRecord firstInvalid;
+			BadRecord firstNonCanonical;
+			BadRecord firstDuplicate;
+
+			bool ok() const { return invalid == 0 && nonCanonical == 0 && duplicates == 0; }
+			// 行号最小的问题记录
+			const BadRecord *firstBad() const;
+		};
+
+		// 按块读取整个输入，块在最后一个换行处截断，余下部分并入下一块。
+		// 各块由工作线程并行解析和检查（列与两组对角线各用一个 64 位掩码），读取线程只在
+		// 排队的块达到线程数的两倍时等待；重复检查按哈希分片的集合记录每个解最早的两次出现，
+		// 结果与线程数无关。空行忽略，行号从 1 开始
+		ValidationReport validateSolutions(std::FILE *in, const ValidateOptions &options);
+
+	} // namespace Cli
+} // namespace NQueens
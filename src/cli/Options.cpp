@@ -0,0 +1,69 @@
+#include "Options.h"
+#include <stdexcept>
+
+namespace NQueens {
+namespace Cli {
+
+Options::Options(int argc, char **argv, const std::set<std::string> &flagNames) {
+    int i = 1;
+    if (i < argc && argv[i][0] != '-') cmd = argv[i++];
+
+    for (; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.size() < 2 || arg[0] != '-') {
+            args.push_back(arg);
+            continue;
+        }
+
+        std::string key = arg.substr(arg[1] == '-' ? 2 : 1);
+        std::string::size_type eq = key.find('=');
+        if (eq != std::string::npos) {
+            values[key.substr(0, eq)] = key.substr(eq + 1);
+        } else if (flagNames.count(key)) {
+            values[key] = "";
+        } else if (i + 1 < argc) {
+            values[key] = argv[++i];
+        } else {
+            throw std::runtime_error("选项缺少参数值: " + arg);
+        }
+    }
+}
+
+bool Options::has(const std::string &key) const {
+    return values.count(key) != 0;
+}
+
+std::string Options::value(const std::string &key, const std::string &fallback) const {
+    auto it = values.find(key);
+    return it == values.end() ? fallback : it->second;
+}
+
+int Options::intValue(const std::string &key, int fallback) const {
+    return (int)int64Value(key, fallback);
+}
+
+long long Options::int64Value(const std::string &key, long long fallback) const {
+    auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    try {
+        size_t used = 0;
+        long long v = std::stoll(it->second, &used);
+        if (used != it->second.size()) throw std::invalid_argument(it->second);
+        return v;
+    } catch (const std::logic_error &) {
+        throw std::runtime_error("选项 --" + key + " 需要整数参数: " + it->second);
+    }
+}
+
+double Options::doubleValue(const std::string &key, double fallback) const {
+    auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    try {
+        return std::stod(it->second);
+    } catch (const std::logic_error &) {
+        throw std::runtime_error("选项 --" + key + " 需要数值参数: " + it->second);
+    }
+}
+
+} // namespace Cli
+} // namespace NQueens
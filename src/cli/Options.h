@@ -0,0 +1,32 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace NQueens {
+	namespace Cli {
+
+		// 简单的命令行解析：<command> [--key value | --key=value | --flag] [positional...]
+		class Options {
+		public:
+			// flagNames 中列出的选项不带参数值
+			Options(int argc, char **argv, const std::set<std::string> &flagNames);
+
+			const std::string &command() const { return cmd; }
+			const std::vector<std::string> &positional() const { return args; }
+
+			bool has(const std::string &key) const;
+			std::string value(const std::string &key, const std::string &fallback = "") const;
+			int intValue(const std::string &key, int fallback) const;
+			long long int64Value(const std::string &key, long long fallback) const;
+			double doubleValue(const std::string &key, double fallback) const;
+
+		private:
+			std::string cmd;
+			std::vector<std::string> args;
+			std::map<std::string, std::string> values;
+		};
+
+	} // namespace Cli
+} // namespace NQueens
@@ -0,0 +1,126 @@
+#include "OutputWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace NQueens {
+namespace Cli {
+
+namespace {
+const size_t FLUSH_THRESHOLD = 1 << 16;
+}
+
+OutputFormat parseFormat(const std::string &name) {
+    if (name == "text") return OutputFormat::Text;
+    if (name == "csv") return OutputFormat::Csv;
+    if (name == "json") return OutputFormat::Json;
+    throw std::runtime_error("未知的输出格式: " + name);
+}
+
+SolutionWriter::SolutionWriter(std::ostream &out, OutputFormat format)
+    : out(out), format(format) {
+    buffer.reserve(FLUSH_THRESHOLD * 2);
+}
+
+SolutionWriter::~SolutionWriter() {
+    flush();
+}
+
+void SolutionWriter::write(const std::vector<int> &queens) {
+    const char sep = format == OutputFormat::Text ? ' ' : ',';
+    if (format == OutputFormat::Csv) {
+        buffer += std::to_string(queens.size());
+        buffer += ',';
+    } else if (format == OutputFormat::Json) {
+        buffer += "{\"n\":" + std::to_string(queens.size()) + ",\"queens\":[";
+    }
+    for (size_t i = 0; i < queens.size(); ++i) {
+        if (i) buffer += sep;
+        buffer += std::to_string(queens[i]);
+    }
+    if (format == OutputFormat::Json) buffer += "]}";
+    buffer += '\n';
+
+    if (buffer.size() >= FLUSH_THRESHOLD) flush();
+}
+
+void SolutionWriter::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), (std::streamsize)buffer.size());
+    buffer.clear();
+}
+
+CountWriter::CountWriter(std::ostream &out, OutputFormat format)
+    : out(out), format(format), headerWritten(false) {}
+
+void CountWriter::write(int n, uint64_t solutions, uint64_t nodes, double ms,
+                        const std::string &status, double fraction) {
+    char msText[32], fractionText[32], percentText[32];
+    std::snprintf(msText, sizeof(msText), "%.3f", ms);
+    std::snprintf(fractionText, sizeof(fractionText), "%.4f", fraction);
+    std::snprintf(percentText, sizeof(percentText), "%.1f", fraction * 100.0);
+    bool partial = status != "completed";
+
+    switch (format) {
+    case OutputFormat::Text:
+        out << "N=" << n << "  解: " << solutions << "  节点: " << nodes
+            << "  耗时: " << msText << " ms";
+        if (partial) out << "  [部分结果: " << status << "，完成约 " << percentText << "%]";
+        out << '\n';
+        break;
+    case OutputFormat::Csv:
+        if (!headerWritten) out << "n,solutions,nodes,ms,status,fraction\n";
+        out << n << ',' << solutions << ',' << nodes << ',' << msText << ',' << status << ','
+            << fractionText << '\n';
+        break;
+    case OutputFormat::Json:
+        out << "{\"n\":" << n << ",\"solutions\":" << solutions << ",\"nodes\":" << nodes
+            << ",\"ms\":" << msText << ",\"status\":\"" << status << "\",\"partial\":"
+            << (partial ? "true" : "false") << ",\"fraction\":" << fractionText << "}\n";
+        break;
+    }
+    headerWritten = true;
+    out.flush();
+}
+
+void writeOccupancy(std::ostream &out, OutputFormat format, int n, uint64_t solutions,
+                    const std::vector<uint64_t> &cells) {
+    switch (format) {
+    case OutputFormat::Text: {
+        out << "N=" << n << "  解: " << solutions << "\n";
+        size_t width = std::to_string(solutions).size() + 1;
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                std::string v = std::to_string(cells[(size_t)r * n + c]);
+                out << std::string(width - std::min(width, v.size()), ' ') << v;
+            }
+            out << '\n';
+        }
+        break;
+    }
+    case OutputFormat::Csv:
+        out << "row,col,count,fraction\n";
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                uint64_t v = cells[(size_t)r * n + c];
+                char fraction[32];
+                std::snprintf(fraction, sizeof(fraction), "%.6f", solutions ? (double)v / solutions : 0.0);
+                out << r << ',' << c << ',' << v << ',' << fraction << '\n';
+            }
+        }
+        break;
+    case OutputFormat::Json:
+        out << "{\"n\":" << n << ",\"solutions\":" << solutions << ",\"cells\":[";
+        for (int r = 0; r < n; ++r) {
+            out << (r ? ",[" : "[");
+            for (int c = 0; c < n; ++c) out << (c ? "," : "") << cells[(size_t)r * n + c];
+            out << ']';
+        }
+        out << "]}\n";
+        break;
+    }
+    out.flush();
+}
+
+} // namespace Cli
+} // namespace NQueens
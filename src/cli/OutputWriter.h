@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace NQueens {
+	namespace Cli {
+
+		enum class OutputFormat { Text, Csv, Json };
+
+		OutputFormat parseFormat(const std::string &name);
+
+		// 解的输出：text 为空格分隔的列号，csv 为 "n,c0,c1,..."，json 为每行一个对象
+		class SolutionWriter {
+		public:
+			SolutionWriter(std::ostream &out, OutputFormat format);
+			~SolutionWriter();
+
+			void write(const std::vector<int> &queens);
+			void flush();
+
+		private:
+			std::ostream &out;
+			OutputFormat format;
+			std::string buffer;
+		};
+
+		// 计数结果的输出：每个 N 一条记录，status 不为 completed 时为部分结果
+		class CountWriter {
+		public:
+			CountWriter(std::ostream &out, OutputFormat format);
+
+			void write(int n, uint64_t solutions, uint64_t nodes, double ms,
+			           const std::string &status = "completed", double fraction = 1.0);
+
+		private:
+			std::ostream &out;
+			OutputFormat format;
+			bool headerWritten;
+		};
+
+		// 逐格占用次数的输出：text 为 n×n 矩阵，csv 为 "row,col,count,fraction"，json 为单个对象
+		void writeOccupancy(std::ostream &out, OutputFormat format, int n, uint64_t solutions,
+		                    const std::vector<uint64_t> &cells);
+
+	} // namespace Cli
+} // namespace NQueens
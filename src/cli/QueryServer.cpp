@@ -0,0 +1,361 @@
+#include "QueryServer.h"
+#include "core/NQueensCounter.h"
+#include "core/Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace NQueens {
+namespace Cli {
+
+namespace {
+
+// 检查停止标志的间隔
+const int ACCEPT_POLL_MS = 200;
+// 等待结果期间检查客户端是否已断开的间隔
+const int PEER_POLL_MS = 100;
+
+const char *const STOPPING_ERROR = "查询服务正在停止";
+
+std::string errorReply(const Core::QueryRequest &request, const std::string &reason) {
+    Core::QueryResponse error;
+    error.ok = false;
+    error.error = reason;
+    return Core::encodeResponse(request, error);
+}
+
+bool readAll(int fd, char *data, size_t size) {
+    while (size > 0) {
+        ssize_t got = ::read(fd, data, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        size -= (size_t)got;
+    }
+    return true;
+}
+
+bool writeAll(int fd, const std::string &data) {
+    const char *p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        // MSG_NOSIGNAL：客户端提前断开时返回错误而不是触发 SIGPIPE
+        ssize_t sent = ::send(fd, p, left, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        p += sent;
+        left -= (size_t)sent;
+    }
+    return true;
+}
+
+// 客户端已关闭连接（读到 EOF 或出错）；尚有未读的请求数据时视为仍在线
+bool peerClosed(int fd) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 0) <= 0) return false;
+    if (pfd.revents & (POLLHUP | POLLERR)) return true;
+    char byte;
+    ssize_t got = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+} // namespace
+
+QueryServer::QueryServer(QueryServerOptions options) : options(std::move(options)), cache(this->options.cacheDir) {
+    if (this->options.socketPath.empty()) throw std::invalid_argument("需要指定套接字路径");
+    int threads = std::max(1, this->options.threads);
+    for (int i = 0; i < threads; ++i) workers.emplace_back(&QueryServer::workerLoop, this);
+}
+
+QueryServer::~QueryServer() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread &worker : workers) worker.join();
+}
+
+QueryServerStats QueryServer::stats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return counters;
+}
+
+void QueryServer::workerLoop() {
+    Core::Trace::setThreadName("query worker");
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        Core::TraceScope scope("job", "server");
+        job();
+    }
+}
+
+void QueryServer::run(const Core::CancellationToken &stop) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options.socketPath.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("套接字路径过长: " + options.socketPath);
+    std::strncpy(addr.sun_path, options.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) throw std::runtime_error(std::string("无法创建套接字: ") + std::strerror(errno));
+    // 上次异常退出留下的套接字文件直接替换
+    ::unlink(options.socketPath.c_str());
+    if (::bind(listener, (sockaddr *)&addr, sizeof(addr)) < 0 || ::listen(listener, 64) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(listener);
+        throw std::runtime_error("无法监听 " + options.socketPath + ": " + reason);
+    }
+
+    while (!stop.isCancelled()) {
+        pollfd pfd{listener, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) continue;
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            counters.connections++;
+        }
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        openConnections.insert(fd);
+        std::thread(&QueryServer::serveConnection, this, fd).detach();
+    }
+
+    ::close(listener);
+    ::unlink(options.socketPath.c_str());
+    // 先拒绝新请求并让在途请求以错误结束（同时取消其计数），再丢弃尚未开始的任务；
+    // 正在执行的计数收到取消后很快返回，其结果不再交付
+    failInflight(STOPPING_ERROR);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.clear();
+    }
+    // 只关闭读端：各连接线程从阻塞读取中返回，已交付的错误回复仍能写出
+    std::unique_lock<std::mutex> lock(connectionMutex);
+    for (int fd : openConnections) ::shutdown(fd, SHUT_RD);
+    connectionClosed.wait(lock, [this]() { return openConnections.empty(); });
+}
+
+void QueryServer::serveConnection(int fd) {
+    Core::Trace::setThreadName("connection " + std::to_string(fd));
+    char header[Core::QUERY_FRAME_HEADER];
+    while (readAll(fd, header, sizeof(header))) {
+        uint32_t length = Core::queryFrameLength(header);
+        if (length > Core::QUERY_MAX_FRAME) break;
+        std::string payload(length, '\0');
+        if (!readAll(fd, &payload[0], length)) break;
+        std::string reply;
+        {
+            Core::TraceScope scope("request", "server", fd);
+            reply = answer(fd, payload);
+        }
+        if (reply.empty() || !writeAll(fd, Core::queryFrame(reply))) break;
+    }
+    ::close(fd);
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    openConnections.erase(fd);
+    connectionClosed.notify_all();
+}
+
+std::string QueryServer::answer(int fd, const std::string &payload) {
+    Core::QueryRequest request;
+    try {
+        request = Core::decodeRequest(payload);
+    } catch (const std::exception &e) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        counters.requests++;
+        counters.errors++;
+        return errorReply(request, e.what());
+    }
+    // 规范编码作为合并键：约束顺序不同但内容相同的请求视为同一请求
+    std::string key = Core::encodeRequest(request);
+    Ticket ticket = submit(key, request);
+    // 客户端放弃请求时会直接断开连接（例如摆放模式下的每次修改），此时退出等待并撤销请求
+    while (ticket.result.wait_for(std::chrono::milliseconds(PEER_POLL_MS)) != std::future_status::ready) {
+        if (peerClosed(fd)) {
+            abandon(key, ticket.promise);
+            return std::string();
+        }
+    }
+    return ticket.result.get();
+}
+
+QueryServer::Ticket QueryServer::submit(const std::string &key, const Core::QueryRequest &request) {
+    Ticket ticket;
+    Core::CancellationToken token;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex);
+        if (draining) {
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            counters.requests++;
+            counters.errors++;
+            std::promise<std::string> refused;
+            refused.set_value(errorReply(request, STOPPING_ERROR));
+            ticket.result = refused.get_future().share();
+            return ticket;
+        }
+        auto it = inflight.find(key);
+        bool joined = it != inflight.end();
+        {
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            counters.requests++;
+            if (joined) counters.coalesced++;
+        }
+        if (joined) {
+            it->second.waiters++;
+            return Ticket{it->second.promise, it->second.result};
+        }
+        ticket.promise = std::make_shared<std::promise<std::string>>();
+        ticket.result = ticket.promise->get_future().share();
+        inflight[key] = Inflight{request, ticket.promise, ticket.result, token, 1};
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        std::shared_ptr<std::promise<std::string>> promise = ticket.promise;
+        jobs.push_back([this, key, request, promise, token]() {
+            Core::QueryResponse response = compute(request, token);
+            if (deliver(key, promise, Core::encodeResponse(request, response)) && !response.ok) {
+                std::lock_guard<std::mutex> statsLock(statsMutex);
+                counters.errors++;
+            }
+        });
+    }
+    jobReady.notify_one();
+    return ticket;
+}
+
+void QueryServer::abandon(const std::string &key, const std::shared_ptr<std::promise<std::string>> &promise) {
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex);
+        auto it = inflight.find(key);
+        if (!promise || it == inflight.end() || it->second.promise != promise) return;
+        if (--it->second.waiters > 0) return;
+        // 最后一个等待者也走了：取消计算并移出在途表，计算线程的结果不再交付
+        it->second.token.cancel();
+        inflight.erase(it);
+    }
+    std::lock_guard<std::mutex> statsLock(statsMutex);
+    counters.abandoned++;
+}
+
+bool QueryServer::deliver(const std::string &key, const std::shared_ptr<std::promise<std::string>> &promise,
+                          const std::string &reply) {
+    // 先移出在途表再交付，之后到达的相同请求会重新计算（通常直接命中缓存）；
+    // 已被 failInflight 移出时说明已经交付过错误回复
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex);
+        auto it = inflight.find(key);
+        if (it == inflight.end() || it->second.promise != promise) return false;
+        inflight.erase(it);
+    }
+    promise->set_value(reply);
+    return true;
+}
+
+void QueryServer::failInflight(const std::string &reason) {
+    std::map<std::string, Inflight> failed;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex);
+        draining = true;
+        failed.swap(inflight);
+    }
+    for (auto &entry : failed) {
+        entry.second.token.cancel();
+        entry.second.promise->set_value(errorReply(entry.second.request, reason));
+    }
+    std::lock_guard<std::mutex> statsLock(statsMutex);
+    counters.errors += failed.size();
+}
+
+QueryServer::IndexSlot &QueryServer::indexFor(int n) {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    std::unique_ptr<IndexSlot> &slot = indexes[n];
+    if (!slot) slot.reset(new IndexSlot);
+    return *slot;
+}
+
+Core::QueryResponse QueryServer::compute(const Core::QueryRequest &request, const Core::CancellationToken &token) {
+    Core::QueryResponse response;
+    try {
+        if (request.op == Core::QueryOp::Count) {
+            // 有约束时缓存键带约束哈希，同一布局的重复查询直接命中
+            Core::NQueensCounter counter = request.fixed.empty() ? Core::NQueensCounter(request.n)
+                                                                 : Core::NQueensCounter(request.n, request.fixed);
+            Core::SearchOptions search;
+            search.cache = &cache;
+            search.token = token;
+            search.budget.timeLimit = options.countTimeLimit;
+            search.budget.maxNodes = options.countMaxNodes;
+            // 计算线程按同时执行的计数平分：单个大请求用满全部线程，并发时不超额订阅
+            int running = ++runningCounts;
+            search.threads = std::max(1, options.threads / running);
+            Core::SearchResult result;
+            try {
+                result = counter.search(search);
+            } catch (...) {
+                --runningCounts;
+                throw;
+            }
+            --runningCounts;
+            if (result.partial) {
+                response.ok = false;
+                response.error = result.status == Core::RunStatus::Cancelled
+                                     ? "计算已取消"
+                                     : std::string("超出服务端的计数预算 (") + Core::runStatusName(result.status) + ")";
+                return response;
+            }
+            response.solutions = result.solutions;
+            response.nodes = result.nodes;
+            return response;
+        }
+
+        if (request.n > options.maxIndexSize)
+            throw std::invalid_argument("服务端只为 N <= " + std::to_string(options.maxIndexSize) + " 建解索引");
+
+        // 解索引不是线程安全的，同一 N 的查询依次执行；不同 N 互不阻塞
+        IndexSlot &slot = indexFor(request.n);
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (!slot.index) {
+            slot.index.reset(new Core::SolutionIndex(request.n, &cache));
+            slot.index->warmUp(std::max(1, request.n / 4));
+        }
+        Core::SolutionIndex &index = *slot.index;
+        switch (request.op) {
+        case Core::QueryOp::Enumerate:
+            for (uint64_t k = request.index; k < request.index + request.count && k < index.total(); ++k)
+                response.boards.push_back(index.unrank(k));
+            break;
+        case Core::QueryOp::Unrank:
+            response.boards.push_back(index.unrank(request.index));
+            break;
+        case Core::QueryOp::Rank:
+            response.index = index.rank(request.queens);
+            break;
+        default:
+            break;
+        }
+    } catch (const std::exception &e) {
+        response = Core::QueryResponse();
+        response.ok = false;
+        response.error = e.what();
+    }
+    return response;
+}
+
+} // namespace Cli
+} // namespace NQueens
@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/QueryProtocol.h"
+#include "core/ResultCache.h"
+#include "core/SearchControl.h"
+#include "core/SolutionIndex.h"
+
+namespace NQueens {
+	namespace Cli {
+
+		struct QueryServerOptions {
+			std::string socketPath;
+			int threads = 1;          // 共享计算线程数；单个计数再按同时执行的计数数平分这些线程并行搜索
+			std::string cacheDir;     // 为空时只在内存中缓存
+			// 单个计数请求的预算，超出时回复错误；0 表示不限制
+			std::chrono::milliseconds countTimeLimit{60000};
+			uint64_t countMaxNodes = 0;
+			// 枚举区间与 rank/unrank 要先对整棵树预热计数，无法中途取消，只接受不超过此值的 N
+			int maxIndexSize = 16;
+		};
+
+		struct QueryServerStats {
+			uint64_t connections = 0;
+			uint64_t requests = 0;
+			uint64_t coalesced = 0;   // 与正在计算的相同请求合并、未单独计算的请求数
+			uint64_t errors = 0;
+			uint64_t abandoned = 0;   // 等待者全部断开、被中途取消的计算数
+		};
+
+		// 常驻查询服务：在 Unix 域套接字上按 Core::QueryProtocol 应答计数、枚举区间、rank/unrank 与约束完成数。
+		// 结果缓存与各 N 的解索引常驻内存；并发到达的相同请求只计算一次，结果分发给所有等待者。
+		class QueryServer {
+		public:
+			explicit QueryServer(QueryServerOptions options);
+			~QueryServer();
+
+			// 阻塞运行，直到 stop 被取消；返回前取消正在执行的计数、让所有在途请求以错误结束，
+			// 关闭所有连接并删除套接字文件
+			void run(const Core::CancellationToken &stop);
+
+			QueryServerStats stats() const;
+
+		private:
+			struct IndexSlot {
+				std::mutex mutex;
+				std::unique_ptr<Core::SolutionIndex> index;
+			};
+
+			// 在途请求：等待者共享 result，promise 由计算线程或停止时的 failInflight 二者之一交付；
+			// 等待者全部断开时由 abandon 取消 token 并移出在途表
+			struct Inflight {
+				Core::QueryRequest request;
+				std::shared_ptr<std::promise<std::string>> promise;
+				std::shared_future<std::string> result;
+				Core::CancellationToken token;
+				int waiters = 1;
+			};
+
+			// submit 的结果；promise 为空表示请求已被拒绝，result 已经就绪
+			struct Ticket {
+				std::shared_ptr<std::promise<std::string>> promise;
+				std::shared_future<std::string> result;
+			};
+
+			void serveConnection(int fd);
+			// 返回应答负载；等待期间客户端断开时返回空串
+			std::string answer(int fd, const std::string &payload);
+			Ticket submit(const std::string &key, const Core::QueryRequest &request);
+			void abandon(const std::string &key, const std::shared_ptr<std::promise<std::string>> &promise);
+			bool deliver(const std::string &key, const std::shared_ptr<std::promise<std::string>> &promise,
+			             const std::string &reply);
+			void failInflight(const std::string &reason);
+			Core::QueryResponse compute(const Core::QueryRequest &request, const Core::CancellationToken &token);
+			IndexSlot &indexFor(int n);
+			void workerLoop();
+
+			QueryServerOptions options;
+			Core::ResultCache cache;
+
+			std::mutex indexMutex;
+			std::map<int, std::unique_ptr<IndexSlot>> indexes;
+
+			// 正在计算的请求，键为规范编码后的请求负载
+			std::mutex inflightMutex;
+			std::map<std::string, Inflight> inflight;
+			bool draining = false;  // failInflight 之后为真，submit 不再接受新请求，直接回复错误
+
+			std::atomic<int> runningCounts{0};  // 正在执行的计数请求数，用于分配每个计数的线程数
+
+			std::mutex jobMutex;
+			std::condition_variable jobReady;
+			std::deque<std::function<void()>> jobs;
+			std::vector<std::thread> workers;
+			bool stopping = false;
+
+			// 每个连接一个分离的线程，run 返回前等待它们全部退出
+			std::mutex connectionMutex;
+			std::condition_variable connectionClosed;
+			std::set<int> openConnections;
+
+			mutable std::mutex statsMutex;
+			QueryServerStats counters;
+		};
+
+	} // namespace Cli
+} // namespace NQueens
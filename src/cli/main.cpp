@@ -0,0 +1,746 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cli/BulkValidator.h"
+#include "cli/Options.h"
+#include "cli/OutputWriter.h"
+#ifdef NQUEENS_HAVE_SERVER
+#include "cli/QueryServer.h"
+#endif
+#include "core/AsyncSolver.h"
+#include "core/FirstSolution.h"
+#include "core/MeetInMiddleCounter.h"
+#include "core/NQueensCounter.h"
+#include "core/PackedSolutions.h"
+#include "core/PerfCounters.h"
+#include "core/RectangularCounter.h"
+#include "core/Sampler.h"
+#include "core/SolutionBitmapIndex.h"
+#include "core/SolutionDag.h"
+#include "core/SolutionIndex.h"
+#include "core/SolutionStream.h"
+#include "core/Trace.h"
+#include "core/TreeEstimator.h"
+#include "core/VariantCounter.h"
+
+using namespace NQueens;
+using namespace NQueens::Cli;
+
+namespace {
+
+const char *USAGE =
+    "用法: nqueens-cli <command> [options]\n"
+    "\n"
+    "命令:\n"
+    "  count        统计 N 皇后解的个数\n"
+    "  enum         枚举全部解\n"
+    "  bench        基准测试：比较逐行搜索、残局表内核与折半计数并校验计数（默认 N=14..16，--reps 重复次数，\n"
+    "               --perf 读取硬件计数器，输出 IPC 与每节点的分支/缓存未命中）\n"
+    "  unrank       按字典序直接取第 K 个解（--index K，--count M 连续取 M 个）\n"
+    "  rank         求解在字典序中的序号（--queens c0,c1,...）\n"
+    "  sample       均匀随机地抽取解（--count M，--seed S，--approx 近似快速模式）\n"
+    "  first        启发式地尽快求出第一个解并报告耗时，可用于数百阶（--order lex|center|lcv，--static-rows，--print）\n"
+    "  rect         M×N 棋盘上放 k 个互不攻击皇后的方案数（-m M -n N，-k K，省略 -k 时列出 0..min(M,N)；\n"
+    "               --check 在小棋盘上用穷举交叉校验）\n"
+    "  dag          把全部解压缩成前缀共享的有向无环图，输出大小（--fixed 约束计数，--queens 成员判断）\n"
+    "  query        建逐格压缩位图索引，列出在给定格子上都有皇后的解（位置参数 R:C,...，可给多个查询；--limit 每个查询\n"
+    "               最多输出 K 个，--check 用带约束的搜索校验匹配数）\n"
+    "  occupancy    统计每个格子在全部解中放有皇后的次数（不生成解）\n"
+    "  serve        常驻查询服务：在 Unix 域套接字上应答计数、枚举区间、rank/unrank（--socket PATH）\n"
+    "  estimate     用随机探测预测搜索树规模与耗时（--probes 探测次数）\n"
+    "  validate     多线程分块校验解文件（[FILE|-]，默认 stdin，--format 与 enum 相同；--canonical 要求字典序最小的\n"
+    "               对称形式，--dedupe 检查重复），报告第一条问题记录，有问题时退出码为 3\n"
+    "\n"
+    "选项:\n"
+    "  -n N                 棋盘大小\n"
+    "  --from A --to B      棋盘大小范围（含两端）\n"
+    "  --threads T          工作线程数，默认为硬件线程数\n"
+    "  --limit K            enum 只输出每个 N 的前 K 个解（惰性生成，提前停止），query 每个查询最多输出 K 个\n"
+    "  --format F           输出格式: text | csv | json（默认 text）\n"
+    "  --timeout MS         count / first 的时间预算，超时返回标记为部分结果的计数；serve 中为单个计数请求的预算\n"
+    "                       （默认 60000，0 不限制），超出时回复错误\n"
+    "  --max-nodes N        count / first / serve 的节点（放置）预算\n"
+    "  --progress           count 时向 stderr 输出进度与剩余时间（Ctrl-C 取消并输出部分结果）\n"
+    "  --cache DIR          count 的结果缓存目录，重复查询直接返回，中断的计算跳过已完成前缀\n"
+    "  --warm D             rank/unrank/sample 预先计算前 D 行全部前缀的子树解数（默认 N/4）\n"
+    "  --seed S             sample / first 的随机种子（默认随机）\n"
+    "  --order O            first 的候选列排序: lex（字典序）| center（从中间向两侧，默认）| lcv（最少约束）\n"
+    "  --cutoff K           first 单次尝试的放置次数上限，超出后随机重启并放大上限（默认 4N）\n"
+    "  --static-rows        first 按行号顺序放置，不先放最受约束的行\n"
+    "  --approx             sample 用随机探测估计上层分支的完成数，不做整棵树的计数（--probes 每个分支的探测次数，默认 16）\n"
+    "  --fixed R:C,...      count/dag/query 只统计在这些固定皇后（第 R 行第 C 列）下的完成数\n"
+    "  --variant V          count 的问题变体: queens | toroidal（环面）| superqueens（皇后加马步）| rooks | bishops（默认 queens）\n"
+    "  --engine E           count 的计数引擎: dfs | mitm（折半计数，不支持预算与进度，默认 dfs）\n"
+    "  --memory-mb M        mitm 半盘记录的内存上限，超出后按分区写入磁盘（默认 256）\n"
+    "  --spill-dir DIR      mitm 溢出文件的目录（默认系统临时目录）\n"
+    "  --socket PATH        serve 监听的套接字路径\n"
+    "  --max-index-n N      serve 只为不超过 N 的棋盘应答枚举区间与 rank/unrank（默认 16）\n"
+    "  --block-mb M         validate 每块读取的大小（默认 8）\n"
+    "  --trace FILE         记录工作单元、排序输出与查询服务的时间线，结束时写成 Chrome trace JSON（可用 Perfetto 打开）\n"
+    "  --help               显示本帮助\n";
+
+struct SizeRange {
+    int from;
+    int to;
+};
+
+SizeRange sizeRange(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    SizeRange range;
+    range.from = opts.intValue("from", n);
+    range.to = opts.intValue("to", opts.has("from") ? range.from : n);
+    if (range.from > range.to) throw std::runtime_error("--from 不能大于 --to");
+    return range;
+}
+
+int threadCount(const Options &opts) {
+    int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    int threads = opts.intValue("threads", hw);
+    if (threads < 1) throw std::runtime_error("--threads 至少为 1");
+    return threads;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Core::CancellationToken interruptToken;
+
+void onInterrupt(int) {
+    interruptToken.cancel();
+}
+
+// "0:3,5:1" 解析为每行的固定列，未指定的行为 -1
+std::vector<int> parseFixed(const std::string &text, int n) {
+    std::vector<int> fixed(n, -1);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(pos, end - pos);
+        size_t colon = item.find(':');
+        int row = -1, col = -1;
+        try {
+            if (colon != std::string::npos) {
+                row = std::stoi(item.substr(0, colon));
+                col = std::stoi(item.substr(colon + 1));
+            }
+        } catch (const std::exception &) {
+            row = -1;
+        }
+        if (row < 0 || row >= n || col < 0 || col >= n)
+            throw std::runtime_error("--fixed 的格式应为 行:列,...，且不超出棋盘: " + item);
+        fixed[row] = col;
+        pos = end + 1;
+    }
+    return fixed;
+}
+
+std::vector<int> fixedColumns(const Options &opts, int n) {
+    if (!opts.has("fixed")) return std::vector<int>();
+    return parseFixed(opts.value("fixed"), n);
+}
+
+Core::MeetInMiddleOptions meetInMiddleOptions(const Options &opts, int threads) {
+    Core::MeetInMiddleOptions options;
+    options.threads = threads;
+    long long memoryMb = opts.int64Value("memory-mb", 256);
+    if (memoryMb < 1) throw std::runtime_error("--memory-mb 至少为 1");
+    options.memoryBudget = (size_t)memoryMb << 20;
+    options.spillDirectory = opts.value("spill-dir", "");
+    return options;
+}
+
+int runMeetInMiddleCount(const Options &opts, Core::ResultCache *cache) {
+    SizeRange range = sizeRange(opts);
+    CountWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+    Core::MeetInMiddleOptions options = meetInMiddleOptions(opts, threadCount(opts));
+
+    for (int n = range.from; n <= range.to; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        Core::MeetInMiddleStats stats;
+        Core::CountResult result = Core::MeetInMiddleCounter(n, options).count(cache, &stats);
+        writer.write(n, result.solutions, result.nodes, elapsedMs(start));
+        if (stats.spilled)
+            std::cerr << "N=" << n << " 半盘记录超出内存上限，已写入磁盘 " << (stats.spilledBytes >> 20) << " MB\n";
+        if (stats.joinPasses > (uint64_t)options.partitions)
+            std::cerr << "N=" << n << " 上半盘分块连接，共扫描下半盘分区 " << stats.joinPasses << " 次\n";
+    }
+    return 0;
+}
+
+// 变体计数：策略模板化的内核，不支持约束、预算与进度
+int runVariantCount(const Options &opts, Core::Variant variant, Core::ResultCache *cache) {
+    if (opts.has("fixed")) throw std::runtime_error("--variant 不支持 --fixed");
+    if (opts.has("engine")) throw std::runtime_error("--variant 不能与 --engine 同时使用");
+    SizeRange range = sizeRange(opts);
+    int threads = threadCount(opts);
+    CountWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+    for (int n = range.from; n <= range.to; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        Core::CountResult result = Core::VariantCounter(n, variant).count(threads, cache);
+        writer.write(n, result.solutions, result.nodes, elapsedMs(start));
+    }
+    return 0;
+}
+
+int runCount(const Options &opts) {
+    SizeRange range = sizeRange(opts);
+    std::unique_ptr<Core::ResultCache> cache;
+    if (opts.has("cache")) cache.reset(new Core::ResultCache(opts.value("cache")));
+
+    Core::Variant variant = Core::parseVariant(opts.value("variant", "queens"));
+    if (variant != Core::Variant::Queens) return runVariantCount(opts, variant, cache.get());
+
+    std::string engine = opts.value("engine", "dfs");
+    if (engine == "mitm") {
+        if (opts.has("fixed")) throw std::runtime_error("mitm 引擎不支持 --fixed");
+        return runMeetInMiddleCount(opts, cache.get());
+    }
+    if (engine != "dfs") throw std::runtime_error("未知计数引擎: " + engine);
+
+    CountWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+
+    Core::SearchOptions options;
+    options.threads = threadCount(opts);
+    options.cache = cache.get();
+    options.token = interruptToken;
+    options.budget.timeLimit = std::chrono::milliseconds(opts.int64Value("timeout", 0));
+    options.budget.maxNodes = (uint64_t)opts.int64Value("max-nodes", 0);
+    if (opts.has("progress")) {
+        options.progressInterval = std::chrono::milliseconds(500);
+        options.onProgress = [](const Core::SearchProgress &p) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "\r进度 %5.1f%%  节点 %llu  已确认解 %llu  剩余 %s",
+                          p.fraction * 100.0, (unsigned long long)p.nodes, (unsigned long long)p.solutions,
+                          p.etaSeconds < 0 ? "--" : (std::to_string((long long)(p.etaSeconds + 0.5)) + " 秒").c_str());
+            std::cerr << line << std::flush;
+        };
+    }
+    std::signal(SIGINT, onInterrupt);
+
+    int exitCode = 0;
+    for (int n = range.from; n <= range.to; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        Core::SearchResult result = Core::NQueensCounter(n, fixedColumns(opts, n)).search(options);
+        if (options.onProgress) std::cerr << '\n';
+        writer.write(n, result.solutions, result.nodes, elapsedMs(start),
+                     Core::runStatusName(result.status), result.fraction);
+        if (result.partial) {
+            exitCode = 2;
+            if (result.status == Core::RunStatus::Cancelled) break;
+        }
+    }
+    return exitCode;
+}
+
+int runEnumerate(const Options &opts) {
+    SizeRange range = sizeRange(opts);
+    int threads = threadCount(opts);
+    SolutionWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+
+    long long limit = opts.int64Value("limit", -1);
+
+    for (int n = range.from; n <= range.to; ++n) {
+        if (limit >= 0) {
+            // 惰性生成器：取到前 K 个即停止，不再搜索剩余部分
+            long long taken = 0;
+            for (const auto &queens : Core::solutionStream(n)) {
+                if (taken++ >= limit) break;
+                writer.write(queens);
+            }
+            continue;
+        }
+        Core::NQueensCounter(n).enumerate([&](const std::vector<int> &queens) {
+            writer.write(queens);
+        }, threads);
+    }
+    writer.flush();
+    return 0;
+}
+
+// 一行基准结果；perf 为空或计数器不可用时省略计数器各列
+void printBenchRow(int n, const std::string &name, double best, uint64_t solutions, double baseline, bool ok,
+                   const Core::PerfSample *perf, uint64_t nodes) {
+    std::printf("%-4d %-10s %12.3f %14.3f %9.2fx %8s", n, name.c_str(), best,
+                best * 1e6 / std::max<uint64_t>(solutions, 1), baseline / best, ok ? "ok" : "MISMATCH");
+    if (perf) {
+        std::printf(" %6.2f", perf->ipc());
+        for (Core::PerfEvent e : {Core::PerfEvent::BranchMisses, Core::PerfEvent::L1dMisses, Core::PerfEvent::LlcMisses}) {
+            double v = perf->per(e, nodes);
+            if (v < 0) std::printf(" %12s", "-");
+            else std::printf(" %12.4f", v);
+        }
+    }
+    std::printf("\n");
+}
+
+int runBench(const Options &opts) {
+    int from = opts.intValue("from", opts.intValue("n", 14));
+    int to = opts.intValue("to", opts.has("n") ? from : 16);
+    int threads = opts.intValue("threads", 1);
+    int reps = std::max(1, opts.intValue("reps", 3));
+
+    // 计数器覆盖全部重复，按总节点数平均；工作线程在计量区间内创建，需要继承
+    std::unique_ptr<Core::PerfCounters> counters;
+    if (opts.has("perf")) {
+        counters = std::make_unique<Core::PerfCounters>(true);
+        if (!counters->available()) {
+            std::cerr << "硬件性能计数器不可用，仅输出耗时: " << counters->error() << '\n';
+            counters.reset();
+        } else if (!counters->error().empty()) {
+            std::cerr << "部分硬件性能计数器不可用: " << counters->error() << '\n';
+        }
+    }
+
+    // 各内核配置：残局表深度 0 即为逐行搜索到底的基准
+    const int depths[] = {0, 2, 3};
+    std::printf("%-4s %-10s %12s %14s %10s %8s", "N", "kernel", "best ms", "ns/solution", "speedup", "check");
+    if (counters) std::printf(" %6s %12s %12s %12s", "IPC", "br-miss/node", "L1d/node", "LLC/node");
+    std::printf("\n");
+
+    int failures = 0;
+    for (int n = from; n <= to; ++n) {
+        double baseline = 0;
+        uint64_t expected = 0;
+        for (int depth : depths) {
+            Core::NQueensCounter counter(n, depth);
+            double best = 1e300;
+            Core::CountResult result;
+            if (counters) counters->start();
+            for (int r = 0; r < reps; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                result = counter.count(threads);
+                best = std::min(best, elapsedMs(start));
+            }
+            Core::PerfSample sample;
+            if (counters) sample = counters->stop();
+            if (depth == 0) {
+                baseline = best;
+                expected = result.solutions;
+            }
+            bool ok = result.solutions == expected;
+            if (!ok) failures++;
+
+            std::string name = counter.endgameDepth() ? "endgame-" + std::to_string(counter.endgameDepth()) : "plain";
+            printBenchRow(n, name, best, result.solutions, baseline, ok, counters ? &sample : nullptr, result.nodes * reps);
+        }
+
+        // 折半计数：节点数远少于 DFS，但连接阶段的候选组合数随 N 快速增长
+        Core::MeetInMiddleCounter meet(n, meetInMiddleOptions(opts, threads));
+        double best = 1e300;
+        Core::CountResult result;
+        if (counters) counters->start();
+        for (int r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            result = meet.count();
+            best = std::min(best, elapsedMs(start));
+        }
+        Core::PerfSample sample;
+        if (counters) sample = counters->stop();
+        bool ok = result.solutions == expected;
+        if (!ok) failures++;
+        printBenchRow(n, "mitm", best, result.solutions, baseline, ok, counters ? &sample : nullptr, result.nodes * reps);
+    }
+    std::fflush(stdout);
+    return failures ? 3 : 0;
+}
+
+std::vector<int> parseQueens(const std::string &text) {
+    std::vector<int> queens;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        try {
+            queens.push_back(std::stoi(text.substr(pos, end - pos)));
+        } catch (const std::exception &) {
+            throw std::runtime_error("--queens 的格式应为逗号分隔的列号: " + text);
+        }
+        pos = end + 1;
+    }
+    return queens;
+}
+
+// 索引的预热与可选的磁盘缓存，rank/unrank 共用
+std::unique_ptr<Core::SolutionIndex> openIndex(const Options &opts, int n, std::unique_ptr<Core::ResultCache> &cache) {
+    if (opts.has("cache")) cache.reset(new Core::ResultCache(opts.value("cache")));
+    std::unique_ptr<Core::SolutionIndex> index(new Core::SolutionIndex(n, cache.get()));
+    index->warmUp(opts.intValue("warm", std::max(1, n / 4)), threadCount(opts));
+    return index;
+}
+
+int runUnrank(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    if (!opts.has("index")) throw std::runtime_error("unrank 需要 --index K");
+    long long first = opts.int64Value("index", 0);
+    long long count = opts.int64Value("count", 1);
+    if (first < 0 || count < 0) throw std::runtime_error("--index 与 --count 不能为负数");
+
+    std::unique_ptr<Core::ResultCache> cache;
+    std::unique_ptr<Core::SolutionIndex> index = openIndex(opts, n, cache);
+    SolutionWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+    uint64_t total = index->total();
+    for (uint64_t k = (uint64_t)first; k < (uint64_t)first + (uint64_t)count && k < total; ++k)
+        writer.write(index->unrank(k));
+    writer.flush();
+    if ((uint64_t)first >= total) {
+        std::cerr << "N=" << n << " 共 " << total << " 个解，--index 超出范围\n";
+        return 1;
+    }
+    return 0;
+}
+
+int runRank(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    if (!opts.has("queens")) throw std::runtime_error("rank 需要 --queens c0,c1,...");
+    std::vector<int> queens = parseQueens(opts.value("queens"));
+    if (!opts.has("n")) n = (int)queens.size();
+
+    std::unique_ptr<Core::ResultCache> cache;
+    std::unique_ptr<Core::SolutionIndex> index = openIndex(opts, n, cache);
+    std::cout << index->rank(queens) << '\n';
+    return 0;
+}
+
+int runFirst(const Options &opts) {
+    SizeRange range = sizeRange(opts);
+    Core::FirstSolutionOptions options;
+    options.order = Core::parseValueOrder(opts.value("order", "center"));
+    options.seed = (uint64_t)opts.int64Value("seed", 0);
+    options.cutoff = (uint64_t)opts.int64Value("cutoff", 0);
+    options.mostConstrainedRow = !opts.has("static-rows");
+    options.budget.timeLimit = std::chrono::milliseconds(opts.int64Value("timeout", 0));
+    options.budget.maxNodes = (uint64_t)opts.int64Value("max-nodes", 0);
+    std::signal(SIGINT, onInterrupt);
+
+    int exitCode = 0;
+    for (int n = range.from; n <= range.to; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        Core::FirstSolutionResult result = Core::FirstSolutionSearch(n, options).run(&interruptToken);
+        double ms = elapsedMs(start);
+        char line[200];
+        std::snprintf(line, sizeof(line), "N=%d  排序: %s  %s: %.3f ms  放置: %llu  重启: %llu", n,
+                      Core::valueOrderName(options.order), result.found ? "首解耗时" : "耗时", ms,
+                      (unsigned long long)result.nodes, (unsigned long long)result.restarts);
+        std::cout << line;
+        if (!result.found) {
+            std::cout << "  " << (result.status == Core::RunStatus::Completed ? "无解" : Core::runStatusName(result.status));
+            if (result.status != Core::RunStatus::Completed) exitCode = 2;
+        }
+        std::cout << '\n';
+        if (result.found && opts.has("print")) {
+            for (int r = 0; r < n; ++r) std::cout << (r ? " " : "") << result.queens[r];
+            std::cout << '\n';
+        }
+        if (result.status == Core::RunStatus::Cancelled) break;
+    }
+    return exitCode;
+}
+
+int runSample(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    long long count = opts.int64Value("count", 1);
+    if (count < 0) throw std::runtime_error("--count 不能为负数");
+
+    Core::SamplerOptions options;
+    options.approximate = opts.has("approx");
+    options.seed = (uint64_t)opts.int64Value("seed", 0);
+    options.threads = threadCount(opts);
+    options.warmDepth = opts.intValue("warm", -1);
+    options.probes = opts.intValue("probes", options.probes);
+
+    std::unique_ptr<Core::ResultCache> cache;
+    if (opts.has("cache")) cache.reset(new Core::ResultCache(opts.value("cache")));
+    auto start = std::chrono::steady_clock::now();
+    Core::Sampler sampler(n, options, cache.get());
+    double setupMs = elapsedMs(start);
+
+    SolutionWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+    start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < count; ++i) writer.write(sampler.next());
+    writer.flush();
+
+    double ms = elapsedMs(start);
+    std::fprintf(stderr, "N=%d %s采样 %lld 个解: 准备 %.1f ms，采样 %.1f ms（%.0f 个/秒）", n,
+                 sampler.exact() ? "精确" : "近似", count, setupMs, ms, count * 1000.0 / std::max(ms, 1e-3));
+    if (!sampler.exact()) std::fprintf(stderr, "，重来 %llu 次", (unsigned long long)sampler.restarts());
+    std::fprintf(stderr, "\n");
+    return 0;
+}
+
+int runRect(const Options &opts) {
+    int rows = opts.intValue("m", opts.intValue("n", 8));
+    int cols = opts.intValue("n", rows);
+    int threads = threadCount(opts);
+    std::unique_ptr<Core::ResultCache> cache;
+    if (opts.has("cache")) cache.reset(new Core::ResultCache(opts.value("cache")));
+
+    int maxQueens = std::min(rows, cols);
+    int from = opts.intValue("k", 0);
+    int to = opts.has("k") ? from : maxQueens;
+    bool check = opts.has("check");
+    if (check && rows * cols > Core::RectangularCounter::BRUTE_FORCE_CELLS)
+        throw std::runtime_error("--check 只适用于不超过 " + std::to_string(Core::RectangularCounter::BRUTE_FORCE_CELLS) +
+                                 " 个格子的棋盘");
+
+    int failures = 0;
+    for (int k = from; k <= to; ++k) {
+        auto start = std::chrono::steady_clock::now();
+        Core::CountResult result = Core::RectangularCounter(rows, cols, k).count(threads, cache.get());
+        char line[160];
+        std::snprintf(line, sizeof(line), "%dx%d k=%-3d 方案: %llu  节点: %llu  耗时: %.3f ms", rows, cols, k,
+                      (unsigned long long)result.solutions, (unsigned long long)result.nodes, elapsedMs(start));
+        std::cout << line;
+        if (check) {
+            uint64_t expected = Core::RectangularCounter::bruteForce(rows, cols, k);
+            bool ok = expected == result.solutions;
+            if (!ok) failures++;
+            std::cout << "  穷举: " << expected << (ok ? "  ok" : "  MISMATCH");
+        }
+        std::cout << '\n';
+    }
+    return failures ? 3 : 0;
+}
+
+int runDag(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    auto start = std::chrono::steady_clock::now();
+    Core::SolutionDag dag(n);
+    double ms = elapsedMs(start);
+
+    // 分别与每个解单独存一个 int 数组、以及 PackedSolutions 的逐解定宽存储相比
+    double raw = (double)dag.size() * n * sizeof(int);
+    double packed = (double)Core::PackedSolutions::bytesFor(n, dag.size());
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "N=%d  解: %llu  节点: %zu  边: %zu  占用: %.2f MB（int 数组的 %.1f%%，PackedSolutions 的 %.1f%%）  构建: %.1f ms\n",
+                  n, (unsigned long long)dag.size(), dag.nodeCount(), dag.edgeCount(), dag.bytes() / 1048576.0,
+                  raw > 0 ? dag.bytes() * 100.0 / raw : 0.0, packed > 0 ? dag.bytes() * 100.0 / packed : 0.0, ms);
+    std::cout << line;
+
+    if (opts.has("fixed")) std::cout << "约束下的解: " << dag.count(fixedColumns(opts, n)) << '\n';
+    if (opts.has("queens")) {
+        bool found = dag.contains(parseQueens(opts.value("queens")));
+        std::cout << (found ? "是合法解\n" : "不是合法解\n");
+        if (!found) return 1;
+    }
+    return 0;
+}
+
+int runServe(const Options &opts) {
+#ifdef NQUEENS_HAVE_SERVER
+    if (!opts.has("socket")) throw std::runtime_error("serve 需要 --socket PATH");
+    QueryServerOptions options;
+    options.socketPath = opts.value("socket");
+    options.threads = threadCount(opts);
+    options.cacheDir = opts.value("cache", "");
+    options.countTimeLimit = std::chrono::milliseconds(opts.int64Value("timeout", options.countTimeLimit.count()));
+    options.countMaxNodes = (uint64_t)opts.int64Value("max-nodes", 0);
+    options.maxIndexSize = opts.intValue("max-index-n", options.maxIndexSize);
+
+    QueryServer server(options);
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    std::cerr << "查询服务已启动: " << options.socketPath << "（" << options.threads << " 个计算线程，Ctrl-C 退出）\n";
+    server.run(interruptToken);
+
+    QueryServerStats stats = server.stats();
+    std::cerr << "连接 " << stats.connections << "，请求 " << stats.requests << "，合并 " << stats.coalesced
+              << "，失败 " << stats.errors << "，中途取消 " << stats.abandoned << '\n';
+    return 0;
+#else
+    (void)opts;
+    throw std::runtime_error("本平台不支持查询服务（需要 Unix 域套接字）");
+#endif
+}
+
+int runOccupancy(const Options &opts) {
+    SizeRange range = sizeRange(opts);
+    int threads = threadCount(opts);
+    OutputFormat format = parseFormat(opts.value("format", "text"));
+    for (int n = range.from; n <= range.to; ++n) {
+        Core::OccupancyMap map = Core::NQueensCounter(n).occupancy(threads);
+        writeOccupancy(std::cout, format, n, map.solutions, map.cells);
+    }
+    return 0;
+}
+
+int runEstimate(const Options &opts) {
+    SizeRange range = sizeRange(opts);
+    int threads = threadCount(opts);
+    int probes = opts.intValue("probes", 20000);
+    int cores = std::min(threads, (int)std::max(1u, std::thread::hardware_concurrency()));
+    double rate = Core::TreeEstimator::measureNodeRate() * cores;
+
+    std::cout << "计数速度约 " << (uint64_t)rate << " 节点/秒（" << cores << " 线程）\n";
+    for (int n = range.from; n <= range.to; ++n) {
+        // 按第 0 行的工作单元分别探测，解数乘上对称权重
+        Core::TreeEstimator estimator(n);
+        double nodes = 0, solutions = 0;
+        for (const Core::WorkUnit &unit : Core::NQueensCounter(n).split(1)) {
+            Core::TreeEstimate est = estimator.estimateUnit(unit, probes);
+            nodes += 1.0 + est.nodes;
+            solutions += est.solutions * unit.weight;
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "N=%d  预计节点: %.3g  预计解: %.3g  预计耗时: %.3g 秒  切分深度: %d\n",
+                      n, nodes, solutions, nodes / rate, estimator.chooseSplitDepth(threads));
+        std::cout << line;
+    }
+    return 0;
+}
+
+int runValidate(const Options &opts) {
+    ValidateOptions options;
+    options.format = parseFormat(opts.value("format", "text"));
+    options.n = opts.intValue("n", 0);
+    options.threads = threadCount(opts);
+    options.canonical = opts.has("canonical");
+    options.duplicates = opts.has("dedupe");
+    long long blockMb = opts.int64Value("block-mb", 8);
+    if (blockMb < 1) throw std::runtime_error("--block-mb 至少为 1");
+    options.blockSize = (size_t)blockMb << 20;
+
+    std::string path = opts.positional().empty() ? "-" : opts.positional()[0];
+    std::FILE *in = stdin;
+    if (path != "-") {
+        in = std::fopen(path.c_str(), "rb");
+        if (!in) throw std::runtime_error("无法打开文件: " + path);
+    }
+    auto start = std::chrono::steady_clock::now();
+    ValidationReport report;
+    try {
+        report = validateSolutions(in, options);
+    } catch (...) {
+        if (in != stdin) std::fclose(in);
+        throw;
+    }
+    if (in != stdin) std::fclose(in);
+    double ms = elapsedMs(start);
+
+    char line[200];
+    std::snprintf(line, sizeof(line), "N=%d  记录: %llu  非法: %llu", report.n, (unsigned long long)report.records,
+                  (unsigned long long)report.invalid);
+    std::cout << line;
+    if (options.canonical) std::cout << "  非规范: " << report.nonCanonical;
+    if (options.duplicates) std::cout << "  重复: " << report.duplicates;
+    std::snprintf(line, sizeof(line), "  %.1f MB  耗时: %.1f ms  %.0f MB/s\n", report.bytes / 1048576.0, ms,
+                  report.bytes / 1048576.0 * 1000.0 / std::max(ms, 1e-3));
+    std::cout << line;
+
+    const BadRecord *bad = report.firstBad();
+    if (!bad) return 0;
+    std::cout << "第一条问题记录: 第 " << bad->line << " 行，" << bad->reason << ": " << bad->text << '\n';
+    return 3;
+}
+
+// 建一次逐格位图索引，依次回答每个查询（位置参数，每个为 R:C,...；没有时用 --fixed，都没有时为全集）
+int runQuery(const Options &opts) {
+    int n = opts.intValue("n", 8);
+    int threads = threadCount(opts);
+    long long limit = opts.int64Value("limit", -1);
+    SolutionWriter writer(std::cout, parseFormat(opts.value("format", "text")));
+
+    auto start = std::chrono::steady_clock::now();
+    Core::PackedSolutions solutions(n);
+    Core::NQueensCounter(n).enumerate([&](const std::vector<int> &queens) { solutions.append(queens); }, threads);
+    Core::SolutionBitmapIndex index(solutions);
+    char line[200];
+    std::snprintf(line, sizeof(line), "N=%d  解: %u  索引: %.2f MB（解 %.2f MB）  构建: %.1f ms\n", n, index.size(),
+                  index.bytes() / 1048576.0, solutions.bytes() / 1048576.0, elapsedMs(start));
+    std::cerr << line;
+
+    std::vector<std::string> queries = opts.positional();
+    if (queries.empty()) queries.push_back(opts.value("fixed", ""));
+    int failures = 0;
+    std::vector<int> queens(n);
+    for (const std::string &text : queries) {
+        std::vector<int> fixed = parseFixed(text, n);
+        start = std::chrono::steady_clock::now();
+        Core::RoaringBitmap matches = index.query(fixed);
+        double ms = elapsedMs(start);
+        std::snprintf(line, sizeof(line), "[%s] 匹配: %llu  查询: %.3f ms", text.c_str(),
+                      (unsigned long long)matches.cardinality(), ms);
+        std::cerr << line;
+        if (opts.has("check")) {
+            // 用带约束的搜索交叉校验
+            uint64_t expected = Core::NQueensCounter(n, fixed).count(threads).solutions;
+            bool ok = expected == matches.cardinality();
+            if (!ok) failures++;
+            std::cerr << "  搜索: " << expected << (ok ? "  ok" : "  MISMATCH");
+        }
+        std::cerr << '\n';
+
+        long long written = 0;
+        matches.forEach([&](uint32_t id) {
+            if (limit >= 0 && written >= limit) return false;
+            solutions.unpack(id, queens.data());
+            writer.write(queens);
+            written++;
+            return true;
+        });
+    }
+    writer.flush();
+    return failures ? 3 : 0;
+}
+
+int runCommand(const Options &opts) {
+    if (opts.command() == "count") return runCount(opts);
+    if (opts.command() == "enum") return runEnumerate(opts);
+    if (opts.command() == "occupancy") return runOccupancy(opts);
+    if (opts.command() == "unrank") return runUnrank(opts);
+    if (opts.command() == "rank") return runRank(opts);
+    if (opts.command() == "sample") return runSample(opts);
+    if (opts.command() == "first") return runFirst(opts);
+    if (opts.command() == "rect") return runRect(opts);
+    if (opts.command() == "dag") return runDag(opts);
+    if (opts.command() == "serve") return runServe(opts);
+    if (opts.command() == "estimate") return runEstimate(opts);
+    if (opts.command() == "bench") return runBench(opts);
+    if (opts.command() == "validate") return runValidate(opts);
+    if (opts.command() == "query") return runQuery(opts);
+
+    std::cerr << "未知命令: " << opts.command() << "\n\n" << USAGE;
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        Options opts(argc, argv, {"help", "h", "progress", "approx", "perf", "check", "static-rows", "print",
+                                         "canonical", "dedupe"});
+        if (opts.has("help") || opts.has("h") || opts.command().empty()) {
+            std::cout << USAGE;
+            return opts.command().empty() && !opts.has("help") && !opts.has("h") ? 1 : 0;
+        }
+        if (!opts.has("trace")) return runCommand(opts);
+
+        // 命令出错时也导出已记录的时间线
+        Core::Trace::start();
+        Core::Trace::setThreadName("main");
+        int status;
+        try {
+            status = runCommand(opts);
+        } catch (...) {
+            Core::Trace::stop();
+            Core::Trace::save(opts.value("trace"));
+            throw;
+        }
+        Core::Trace::stop();
+        Core::Trace::save(opts.value("trace"));
+        return status;
+    } catch (const std::exception &e) {
+        std::cerr << "错误: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -8,6 +8,9 @@ namespace Config {
 
     // --- 常量 ---
     const int DEFAULT_BOARD_SIZE = 8;
+    const int MIN_DEMO_SIZE = 4;
+    const int MAX_DEMO_SIZE = 14;      // 逐步演示的上限
+    const int MAX_WHAT_IF_SIZE = 16;   // 摆放模式只在后台计数，上限更高
     const int INITIAL_CELL_SIZE = 80;
     const int SOLUTION_PAUSE_MS = 1000;
 
@@ -26,6 +29,8 @@ namespace Config {
         const QColor ButtonBg("#0EA5E9");
         const QColor ButtonHover("#38BDF8");
         const QColor ButtonPause("#F59E0B");
+        const QColor Heatmap("#8B5CF6");
+        const QColor Skipped("#64748B");
     }
 
     // --- 速度配置 ---
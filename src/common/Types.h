@@ -1,19 +1,25 @@
 #pragma once
-#include <QVector>
-#include <QPair>
+#include <cstdint>
+#include <vector>
+#include <utility>
 
 namespace NQueens {
 
+	// 演示的步进方式：逐列试探每个格子，或只遍历当前行的可放位置（最低位技巧，与位运算求解器的节点一致），
+	// 或用启发式搜索尽快找到第一个解（先放最受约束的行，候选列从中间向两侧，找到即结束）
+	enum class StepMode { EveryColumn, FreeBits, FirstSolution };
+
 	struct SolverState {
-		QVector<int> queens;
-		QPair<int, int> trialPos;
-		bool hasConflict;
-		bool solutionFound;
-		int solutionsCount;
-		int newSolutionsFound;
-		int stepsCount;
-		bool isFinished;
-		bool isSymmetricBase;
+		std::vector<int> queens;
+		std::pair<int, int> trialPos{-1, -1};
+		bool hasConflict = false;
+		bool solutionFound = false;
+		int solutionsCount = 0;
+		int newSolutionsFound = 0;
+		int stepsCount = 0;
+		bool isFinished = false;
+		bool isSymmetricBase = false;
+		uint32_t skippedMask = 0;  // FreeBits 模式下试探行中因受攻击而直接跳过的列
 	};
 
-} // namespace NQueens
\ No newline at end of file
+} // namespace NQueens
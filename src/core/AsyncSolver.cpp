@@ -0,0 +1,48 @@
+#include "AsyncSolver.h"
+
+namespace NQueens {
+namespace Core {
+
+const char *runStatusName(RunStatus status) {
+    switch (status) {
+    case RunStatus::Completed: return "completed";
+    case RunStatus::Cancelled: return "cancelled";
+    case RunStatus::TimedOut: return "timeout";
+    case RunStatus::NodeLimit: return "node-limit";
+    }
+    return "unknown";
+}
+
+SearchHandle::SearchHandle(std::future<SearchResult> future, CancellationToken token)
+    : future(std::move(future)), token(std::move(token)) {}
+
+void SearchHandle::cancel() {
+    token.cancel();
+}
+
+bool SearchHandle::isReady() const {
+    return waitFor(std::chrono::milliseconds(0));
+}
+
+bool SearchHandle::waitFor(std::chrono::milliseconds timeout) const {
+    return future.wait_for(timeout) == std::future_status::ready;
+}
+
+SearchResult SearchHandle::get() {
+    return future.get();
+}
+
+SearchHandle searchAsync(int n, SearchOptions options) {
+    return searchAsync(NQueensCounter(n), std::move(options)); // 参数错误在调用线程上抛出
+}
+
+SearchHandle searchAsync(NQueensCounter counter, SearchOptions options) {
+    CancellationToken token = options.token;
+    std::future<SearchResult> future = std::async(std::launch::async, [counter, options]() {
+        return counter.search(options);
+    });
+    return SearchHandle(std::move(future), token);
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+#include <future>
+#include "NQueensCounter.h"
+#include "SearchControl.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 后台计数任务的句柄
+		class SearchHandle {
+		public:
+			SearchHandle(std::future<SearchResult> future, CancellationToken token);
+
+			// 请求取消，工作线程在下一次检查点退出，结果标记为 Cancelled
+			void cancel();
+
+			bool isReady() const;
+			bool waitFor(std::chrono::milliseconds timeout) const;
+
+			// 阻塞直到结束并取回结果，只能调用一次
+			SearchResult get();
+
+		private:
+			std::future<SearchResult> future;
+			CancellationToken token;
+		};
+
+		// 在后台线程上运行 NQueensCounter::search；进度回调在该后台线程上调用
+		SearchHandle searchAsync(int n, SearchOptions options);
+		SearchHandle searchAsync(NQueensCounter counter, SearchOptions options);
+
+	} // namespace Core
+} // namespace NQueens
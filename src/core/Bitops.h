@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace NQueens {
+	namespace Core {
+
+		// 支持的最大棋盘边长（掩码使用 32 位无符号整数）
+		constexpr int MAX_BOARD_SIZE = 31;
+
+		inline uint32_t fullMask(int n) {
+			return (1u << n) - 1;
+		}
+
+		inline uint32_t lowestBit(uint32_t x) {
+			return x & (0u - x);
+		}
+
+		inline int bitIndex(uint32_t x) {
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward(&idx, x);
+			return (int)idx;
+#else
+			return __builtin_ctz(x);
+#endif
+		}
+
+		inline int popCount(uint32_t x) {
+#if defined(_MSC_VER)
+			return (int)__popcnt(x);
+#else
+			return __builtin_popcount(x);
+#endif
+		}
+
+		inline int bitIndex64(uint64_t x) {
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward64(&idx, x);
+			return (int)idx;
+#else
+			return __builtin_ctzll(x);
+#endif
+		}
+
+		inline int popCount64(uint64_t x) {
+#if defined(_MSC_VER)
+			return (int)__popcnt64(x);
+#else
+			return __builtin_popcountll(x);
+#endif
+		}
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,56 @@
+#include "EndgameTable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+EndgameTable::EndgameTable(int n, int depth) : n(n), k(depth), full(fullMask(n)) {
+    if (k < 2 || k > MAX_DEPTH || k >= n)
+        throw std::invalid_argument("残局表深度无效: " + std::to_string(k));
+
+    // perms[p][i] = 第 i 个剩余行所放的空列序号
+    std::vector<std::vector<int>> perms;
+    std::vector<int> p(k);
+    for (int i = 0; i < k; ++i) p[i] = i;
+    do {
+        perms.push_back(p);
+    } while (std::next_permutation(p.begin(), p.end()));
+
+    // 列间距表：最后 k 个皇后之间的对角线冲突只取决于空列之间的距离
+    int gapCount = k == 3 ? n * n : n;
+    gapPerms.assign(gapCount, 0);
+    for (int g1 = 1; g1 < n; ++g1) {
+        for (int g2 = 1; g2 < (k == 3 ? n : 2); ++g2) {
+            int f[MAX_DEPTH] = {0, g1, g1 + g2};
+            if (f[k - 1] >= n) continue;
+            uint8_t mask = 0;
+            for (size_t pi = 0; pi < perms.size(); ++pi) {
+                bool ok = true;
+                for (int a = 0; a < k && ok; ++a)
+                    for (int b = a + 1; b < k && ok; ++b)
+                        ok = std::abs(f[perms[pi][a]] - f[perms[pi][b]]) != b - a;
+                if (ok) mask |= uint8_t(1u << pi);
+            }
+            gapPerms[k == 3 ? g1 * n + g2 : g1] = mask;
+        }
+    }
+
+    // 受攻击格表：第 i 行第 j 个空列受攻击时，排除所有把该行放在该列的排列
+    blockedPerms.assign(size_t(1) << (k * k), 0);
+    for (uint32_t blocked = 0; blocked < blockedPerms.size(); ++blocked) {
+        uint8_t mask = 0;
+        for (size_t pi = 0; pi < perms.size(); ++pi) {
+            bool ok = true;
+            for (int i = 0; i < k && ok; ++i)
+                ok = !((blocked >> (i * k + perms[pi][i])) & 1u);
+            if (ok) mask |= uint8_t(1u << pi);
+        }
+        blockedPerms[blocked] = mask;
+    }
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bitops.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 最后 depth 行（2 或 3）的完成数查表。
+		// 剩余 depth 个空列记为 f0 < f1 < ...，一个完成方案就是这些列的一个排列：
+		//   gapPerms[列间距]      —— 最后几个皇后彼此之间不冲突的排列（只与间距有关）
+		//   blockedPerms[受攻击格] —— 不落在上方皇后攻击格上的排列
+		// 两者按位与后的 popcount 即完成数。两张表合计不超过几 KB，常驻 L1。
+		class EndgameTable {
+		public:
+			static constexpr int MAX_DEPTH = 3;
+
+			EndgameTable(int n, int depth);
+
+			int depth() const { return k; }
+
+			// 在第 n-depth 行处（恰好剩 depth 个空列）返回剩余各行的完成数
+			int completions(uint32_t cols, uint32_t ld, uint32_t rd) const {
+				uint32_t freeCols = full & ~cols;
+				int f[MAX_DEPTH] = {};
+				for (int j = 0; j < k; ++j) {
+					f[j] = bitIndex(freeCols);
+					freeCols &= freeCols - 1;
+				}
+
+				uint32_t blocked = 0;
+				for (int i = 0; i < k; ++i) {
+					uint32_t attacked = (ld << i) | (rd >> i);
+					for (int j = 0; j < k; ++j)
+						blocked |= ((attacked >> f[j]) & 1u) << (i * k + j);
+				}
+
+				int gap = f[1] - f[0];
+				if (k == 3) gap = gap * n + (f[2] - f[1]);
+				return popCount(gapPerms[gap] & blockedPerms[blocked]);
+			}
+
+			size_t bytes() const { return gapPerms.size() + blockedPerms.size(); }
+
+		private:
+			int n;
+			int k;
+			uint32_t full;
+			std::vector<uint8_t> gapPerms;
+			std::vector<uint8_t> blockedPerms;
+		};
+
+	} // namespace Core
+} // namespace NQueens
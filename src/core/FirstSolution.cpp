@@ -0,0 +1,231 @@
+#include "FirstSolution.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace NQueens {
+namespace Core {
+
+const char *valueOrderName(ValueOrder order) {
+    switch (order) {
+    case ValueOrder::Lexicographic: return "lex";
+    case ValueOrder::CenterOut: return "center";
+    case ValueOrder::LeastConstraining: return "lcv";
+    }
+    return "lcv";
+}
+
+ValueOrder parseValueOrder(const std::string &name) {
+    for (ValueOrder o : {ValueOrder::Lexicographic, ValueOrder::CenterOut, ValueOrder::LeastConstraining})
+        if (name == valueOrderName(o)) return o;
+    throw std::invalid_argument("未知的候选排序: " + name + "（可选 lex | center | lcv）");
+}
+
+FirstSolutionSearch::FirstSolutionSearch(int n, FirstSolutionOptions options)
+    : n(n), options(options), rng(options.seed ? options.seed : std::random_device{}()) {
+    if (n < 1 || n > MAX_SIZE) throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+    if (options.cutoffGrowth <= 1.0) throw std::invalid_argument("重启上限的放大倍数必须大于 1");
+}
+
+void FirstSolutionSearch::restart() {
+    queens.assign(n, -1);
+    colUsed.assign(n, 0);
+    downUsed.assign(2 * n - 1, 0);
+    upUsed.assign(2 * n - 1, 0);
+    freeCount.assign(n, n);
+    rowAt.assign(n, -1);
+    candidates.assign(n, {});
+    nextCandidate.assign(n, 0);
+    depth = 0;
+    attemptNodes = 0;
+    prepare(0);
+}
+
+bool FirstSolutionSearch::isFree(int r, int c) const {
+    return !colUsed[c] && !downUsed[r + c] && !upUsed[r - c + n - 1];
+}
+
+// 另一行 other 上受 (r, c) 攻击的格子至多 3 个（同列与两条对角线），返回其中当前可放的个数
+int FirstSolutionSearch::freeCellsHit(int r, int c, int other) const {
+    int d = std::abs(other - r);
+    int hit = isFree(other, c);
+    if (c - d >= 0) hit += isFree(other, c - d);
+    if (c + d < n) hit += isFree(other, c + d);
+    return hit;
+}
+
+int FirstSolutionSearch::newlyAttacked(int r, int c) const {
+    int total = 0;
+    for (int other = 0; other < n; ++other)
+        if (other != r && queens[other] < 0) total += freeCellsHit(r, c, other);
+    return total;
+}
+
+void FirstSolutionSearch::prepare(int at) {
+    // 选行：剩余可放格子最少的未放行，相同时随机取一个
+    int r = -1;
+    if (options.mostConstrainedRow) {
+        int best = n + 1;
+        int ties = 0;
+        for (int other = 0; other < n; ++other) {
+            if (queens[other] >= 0) continue;
+            if (freeCount[other] < best) {
+                best = freeCount[other];
+                r = other;
+                ties = 1;
+            } else if (freeCount[other] == best && std::uniform_int_distribution<int>(0, ties++)(rng) == 0) {
+                r = other;
+            }
+        }
+    } else {
+        r = at;
+    }
+    rowAt[at] = r;
+
+    std::vector<int> &list = candidates[at];
+    list.clear();
+    nextCandidate[at] = 0;
+    for (int c = 0; c < n; ++c)
+        if (isFree(r, c)) list.push_back(c);
+    if (options.order == ValueOrder::Lexicographic) return;
+
+    // 先打乱再稳定排序，相同优先级的候选按随机顺序尝试，每次重启走不同的路径
+    std::shuffle(list.begin(), list.end(), rng);
+    std::vector<std::pair<int, int>> keyed;
+    keyed.reserve(list.size());
+    for (int c : list) {
+        int key = options.order == ValueOrder::CenterOut ? std::abs(2 * c - (n - 1)) : newlyAttacked(r, c);
+        keyed.push_back({key, c});
+    }
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (size_t i = 0; i < keyed.size(); ++i) list[i] = keyed[i].second;
+}
+
+// 先按落子前的状态扣减其余未放行的可放格子数，再标记列与对角线；某行减到 0 时返回 false，由调用方撤销
+bool FirstSolutionSearch::place(int r, int c) {
+    bool alive = true;
+    for (int other = 0; other < n; ++other) {
+        if (other == r || queens[other] >= 0) continue;
+        freeCount[other] -= freeCellsHit(r, c, other);
+        if (freeCount[other] == 0) alive = false;
+    }
+    queens[r] = c;
+    colUsed[c] = downUsed[r + c] = upUsed[r - c + n - 1] = 1;
+    return alive;
+}
+
+// 按后进先出撤销：撤掉后重新可放的格子正是落子时扣减的那些
+void FirstSolutionSearch::remove(int r, int c) {
+    queens[r] = -1;
+    colUsed[c] = downUsed[r + c] = upUsed[r - c + n - 1] = 0;
+    for (int other = 0; other < n; ++other)
+        if (other != r && queens[other] < 0) freeCount[other] += freeCellsHit(r, c, other);
+}
+
+FirstSolutionSearch::Event FirstSolutionSearch::advance() {
+    if (nextCandidate[depth] == candidates[depth].size()) {
+        if (depth == 0) return Event::Exhausted;
+        --depth;
+        remove(rowAt[depth], queens[rowAt[depth]]);
+        return Event::Backtracked;
+    }
+    int r = rowAt[depth];
+    int c = candidates[depth][nextCandidate[depth]++];
+    nodes++;
+    attemptNodes++;
+    if (!place(r, c)) {
+        remove(r, c);
+        return Event::Rejected;
+    }
+    if (++depth == n) return Event::Solved;
+    prepare(depth);
+    return Event::Placed;
+}
+
+bool FirstSolutionSearch::checkCutoff() {
+    if (options.order == ValueOrder::Lexicographic || attemptNodes < cutoff) return false;
+    cutoff = uint64_t(double(cutoff) * options.cutoffGrowth) + 1;
+    restarts++;
+    restart();
+    return true;
+}
+
+FirstSolutionResult FirstSolutionSearch::run(const CancellationToken *token) {
+    const uint64_t CHECK_INTERVAL = 1 << 12;
+    auto start = std::chrono::steady_clock::now();
+    nodes = 0;
+    restarts = 0;
+    cutoff = options.cutoff ? options.cutoff : 4 * (uint64_t)n;
+    restart();
+
+    FirstSolutionResult result;
+    for (;;) {
+        Event event = advance();
+        if (event == Event::Solved) {
+            result.found = true;
+            result.queens = queens;
+            break;
+        }
+        if (event == Event::Exhausted) break;
+        checkCutoff();
+        if ((nodes & (CHECK_INTERVAL - 1)) == 0) {
+            if (token && token->isCancelled()) {
+                result.status = RunStatus::Cancelled;
+                break;
+            }
+            if (options.budget.maxNodes && nodes >= options.budget.maxNodes) {
+                result.status = RunStatus::NodeLimit;
+                break;
+            }
+            if (options.budget.timeLimit.count() > 0 && std::chrono::steady_clock::now() - start >= options.budget.timeLimit) {
+                result.status = RunStatus::TimedOut;
+                break;
+            }
+        }
+    }
+    result.nodes = nodes;
+    result.restarts = restarts;
+    return result;
+}
+
+Generator<SolverState> FirstSolutionSearch::steps() {
+    nodes = 0;
+    restarts = 0;
+    cutoff = options.cutoff ? options.cutoff : 4 * (uint64_t)n;
+    restart();
+
+    // 每一步改写同一个状态再产生其引用，棋盘按元素复制，不逐步分配
+    SolverState state;
+    state.queens.assign(n, -1);
+    for (;;) {
+        Event event = advance();
+        if (event == Event::Exhausted) co_return;
+        // 回溯与重启本身不是一步，下一次放置时棋盘自然反映出来
+        if (event == Event::Backtracked) {
+            checkCutoff();
+            continue;
+        }
+
+        int at = event == Event::Rejected ? depth : depth - 1;
+        int trialRow = rowAt[at];
+        int trialCol = candidates[at][nextCandidate[at] - 1];
+        state.queens = queens;
+        state.queens[trialRow] = -1;
+        state.trialPos = {trialRow, trialCol};
+        state.hasConflict = event == Event::Rejected;
+        state.stepsCount = (int)nodes;
+        state.solutionFound = false;
+        if (event == Event::Solved) {
+            state.solutionFound = true;
+            state.newSolutionsFound = 1;
+            state.solutionsCount = 1;
+            co_yield state;
+            co_return;
+        }
+        co_yield state;
+        checkCutoff();
+    }
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/Types.h"
+#include "Generator.h"
+#include "SearchControl.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 候选列的排序：字典序（与 NQueensSolver 相同，作对照）、从中间向两侧、
+		// 或最少约束（优先选择使后续各行失去可放格子最少的列）
+		enum class ValueOrder { Lexicographic, CenterOut, LeastConstraining };
+
+		const char *valueOrderName(ValueOrder order);
+		// 未知名称抛出 invalid_argument
+		ValueOrder parseValueOrder(const std::string &name);
+
+		struct FirstSolutionOptions {
+			ValueOrder order = ValueOrder::CenterOut;
+			uint64_t seed = 0;             // 0 表示随机种子
+			uint64_t cutoff = 0;           // 单次尝试的放置次数上限，0 表示 4n；字典序下不重启
+			double cutoffGrowth = 1.5;     // 每次重启后上限放大的倍数，保证最终能搜完整棵树
+			bool mostConstrainedRow = true; // 每次先放剩余可放格子最少的行；false 时按行号顺序
+			SearchBudget budget;           // 总预算，超出后放弃
+		};
+
+		struct FirstSolutionResult {
+			bool found = false;
+			RunStatus status = RunStatus::Completed;  // 不为 Completed 时 found 为 false
+			std::vector<int> queens;
+			uint64_t nodes = 0;        // 全部尝试的放置次数
+			uint64_t restarts = 0;
+		};
+
+		// 求第一个解的启发式搜索，不依赖位掩码，可用于数百阶的棋盘。
+		// 每次选一行放置（默认选剩余可放格子最少的行），候选列按 ValueOrder 排列（相同优先级随机打破），
+		// 放置后做前向检查：维护其余每一行剩余的可放格子数，某行减到 0 时立即撤销。
+		// 单次尝试超过放置次数上限时以新的随机顺序重新开始（随机重启），上限逐次放大。
+		// 只按行号顺序并用字典序时，放置顺序与 NQueensSolver 一致（另加前向检查）
+		class FirstSolutionSearch {
+		public:
+			static constexpr int MAX_SIZE = 1000;
+
+			FirstSolutionSearch(int n, FirstSolutionOptions options = {});
+
+			FirstSolutionResult run(const CancellationToken *token = nullptr);
+
+			// 可视化用的逐步事件：每次放置（前向检查失败时 hasConflict 为真）为一步，
+			// 找到解时 solutionFound 为真，随后结束
+			Generator<SolverState> steps();
+
+		private:
+			enum class Event { Placed, Rejected, Backtracked, Solved, Exhausted };
+
+			void restart();
+			// 为第 depth 个要放的行选定行号并排列候选列
+			void prepare(int depth);
+			Event advance();
+			bool isFree(int row, int col) const;
+			int freeCellsHit(int row, int col, int other) const;
+			// 在 (row, col) 落子会使其余未放的行失去的可放格子总数
+			int newlyAttacked(int row, int col) const;
+			bool place(int row, int col);
+			void remove(int row, int col);
+			// 达到本次尝试的上限时重启，返回是否发生了重启
+			bool checkCutoff();
+
+			int n;
+			FirstSolutionOptions options;
+			std::mt19937_64 rng;
+			std::vector<int> queens;
+			std::vector<char> colUsed;
+			std::vector<char> downUsed;  // 下标 row + col
+			std::vector<char> upUsed;    // 下标 row - col + n - 1
+			std::vector<int> freeCount;  // 未放的行剩余的可放格子数
+			std::vector<int> rowAt;      // 第 depth 个放下的行
+			std::vector<std::vector<int>> candidates;  // 按 depth 保存
+			std::vector<size_t> nextCandidate;
+			int depth = 0;
+			uint64_t nodes = 0;
+			uint64_t attemptNodes = 0;
+			uint64_t cutoff = 0;
+			uint64_t restarts = 0;
+		};
+
+	} // namespace Core
+} // namespace NQueens
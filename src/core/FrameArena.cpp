@@ -0,0 +1,63 @@
+#include "FrameArena.h"
+#include <new>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+const std::size_t GRANULE = 64;
+const std::size_t CLASS_COUNT = 64; // 最大 4096 字节，更大的帧直接走全局分配
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+struct FreeLists {
+    FreeBlock *heads[CLASS_COUNT] = {};
+
+    ~FreeLists() {
+        for (FreeBlock *&head : heads) {
+            while (head) {
+                FreeBlock *next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+};
+
+thread_local FreeLists lists;
+
+std::size_t sizeClass(std::size_t size) {
+    return (size + GRANULE - 1) / GRANULE;
+}
+
+} // namespace
+
+void *FrameArena::allocate(std::size_t size) {
+    std::size_t cls = sizeClass(size);
+    if (cls >= CLASS_COUNT) return ::operator new(size);
+
+    FreeBlock *&head = lists.heads[cls];
+    if (head) {
+        FreeBlock *block = head;
+        head = block->next;
+        return block;
+    }
+    return ::operator new(cls * GRANULE);
+}
+
+void FrameArena::release(void *p, std::size_t size) {
+    std::size_t cls = sizeClass(size);
+    if (cls >= CLASS_COUNT) {
+        ::operator delete(p);
+        return;
+    }
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = lists.heads[cls];
+    lists.heads[cls] = block;
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+namespace NQueens {
+	namespace Core {
+
+		// 协程帧分配器：按 64 字节分级的线程局部空闲链表，帧释放后留给下一次复用，
+		// 预热后创建/销毁生成器不再调用全局 operator new
+		class FrameArena {
+		public:
+			static void *allocate(std::size_t size);
+			static void release(void *p, std::size_t size);
+		};
+
+	} // namespace Core
+} // namespace NQueens
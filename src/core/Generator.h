@@ -0,0 +1,97 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+#include "FrameArena.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 惰性生成器：co_yield 只传递被产生值的地址，不复制也不分配；
+		// 协程帧由 FrameArena 分配。迭代器解引用得到的引用在下一次 ++ 之前有效。
+		template <class T>
+		class Generator {
+		public:
+			struct promise_type {
+				const T *current = nullptr;
+				std::exception_ptr error;
+
+				Generator get_return_object() {
+					return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+				}
+				std::suspend_always initial_suspend() noexcept { return {}; }
+				std::suspend_always final_suspend() noexcept { return {}; }
+
+				std::suspend_always yield_value(const T &value) noexcept {
+					current = std::addressof(value);
+					return {};
+				}
+
+				void return_void() noexcept {}
+				void unhandled_exception() { error = std::current_exception(); }
+
+				static void *operator new(std::size_t size) { return FrameArena::allocate(size); }
+				static void operator delete(void *p, std::size_t size) { FrameArena::release(p, size); }
+			};
+
+			using Handle = std::coroutine_handle<promise_type>;
+
+			class iterator {
+			public:
+				using value_type = T;
+				using difference_type = std::ptrdiff_t;
+
+				iterator() = default;
+				explicit iterator(Handle h) : handle(h) {}
+
+				const T &operator*() const { return *handle.promise().current; }
+				const T *operator->() const { return handle.promise().current; }
+
+				iterator &operator++() {
+					advance(handle);
+					return *this;
+				}
+				void operator++(int) { ++*this; }
+
+				bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+
+			private:
+				Handle handle;
+			};
+
+			Generator() = default;
+			Generator(Generator &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+			Generator &operator=(Generator &&other) noexcept {
+				if (this != &other) {
+					if (handle) handle.destroy();
+					handle = std::exchange(other.handle, {});
+				}
+				return *this;
+			}
+			Generator(const Generator &) = delete;
+			Generator &operator=(const Generator &) = delete;
+			~Generator() {
+				if (handle) handle.destroy();
+			}
+
+			iterator begin() {
+				if (handle && !handle.done()) advance(handle);
+				return iterator(handle);
+			}
+			std::default_sentinel_t end() const noexcept { return {}; }
+
+		private:
+			explicit Generator(Handle h) : handle(h) {}
+
+			static void advance(Handle h) {
+				h.resume();
+				if (h.done() && h.promise().error) std::rethrow_exception(h.promise().error);
+			}
+
+			Handle handle;
+		};
+
+	} // namespace Core
+} // namespace NQueens
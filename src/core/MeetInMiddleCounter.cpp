@@ -0,0 +1,267 @@
+#include "MeetInMiddleCounter.h"
+#include "Bitops.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 半盘记录：所用列集合与两组绝对对角线（r+c、r-c+n-1）
+struct HalfRecord {
+    uint32_t cols;
+    uint32_t weight;
+    uint64_t d1;
+    uint64_t d2;
+};
+
+const size_t READ_CHUNK = 1 << 16;
+
+// 连接时每条上半盘记录的内存估计：记录本身加上按列集合分组的哈希表项
+const size_t JOIN_BYTES_PER_RECORD = sizeof(HalfRecord) + 48;
+const size_t MIN_JOIN_RECORDS = 1 << 12;
+
+uint32_t partitionOf(uint32_t cols, int partitions) {
+    uint64_t h = (uint64_t)cols * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)((h >> 32) % (uint64_t)partitions);
+}
+
+// 溢出文件所在的临时目录，首次溢出时创建，析构时整体删除
+class SpillDirectory {
+public:
+    explicit SpillDirectory(std::string parent) : parent(std::move(parent)) {}
+    ~SpillDirectory() {
+        std::error_code ec;
+        if (!dir.empty()) std::filesystem::remove_all(dir, ec);
+    }
+
+    const std::filesystem::path &path() {
+        if (dir.empty()) {
+            std::filesystem::path base = parent.empty() ? std::filesystem::temp_directory_path()
+                                                        : std::filesystem::path(parent);
+            char name[40];
+            std::snprintf(name, sizeof(name), "nqueens-mitm-%016llx",
+                          (unsigned long long)std::random_device{}() << 32 ^ std::random_device{}());
+            dir = base / name;
+            std::filesystem::create_directories(dir);
+        }
+        return dir;
+    }
+
+private:
+    std::string parent;
+    std::filesystem::path dir;
+};
+
+// 一侧半盘的分区存储：先缓存在内存中，总量超出预算时把所有分区追加写入各自的文件
+class PartitionStore {
+public:
+    PartitionStore(int partitions, size_t budgetRecords, SpillDirectory &spillDir, std::string tag)
+        : buffers(partitions), onDisk(partitions, 0), budgetRecords(std::max<size_t>(budgetRecords, 1)),
+          spillDir(spillDir), tag(std::move(tag)) {}
+
+    void add(uint32_t part, const HalfRecord &r) {
+        buffers[part].push_back(r);
+        if (++buffered >= budgetRecords) spill();
+    }
+
+    bool spilled() const { return spilledBytes > 0; }
+    uint64_t bytesSpilled() const { return spilledBytes; }
+
+    // 把仍在内存中的记录全部写入磁盘，释放缓冲区
+    void flush() {
+        if (buffered) spill();
+    }
+
+    // 按每块最多 chunkRecords 条载入一个分区，逐块回调
+    template <class Visit>
+    void scanChunks(size_t part, size_t chunkRecords, Visit visit) const {
+        std::vector<HalfRecord> chunk;
+        chunk.reserve(std::min(chunkRecords, onDisk[part] + buffers[part].size()));
+        scan(part, [&](const HalfRecord &r) {
+            chunk.push_back(r);
+            if (chunk.size() < chunkRecords) return;
+            visit(chunk);
+            chunk.clear();
+        });
+        if (!chunk.empty()) visit(chunk);
+    }
+
+    template <class Visit>
+    void scan(size_t part, Visit visit) const {
+        if (onDisk[part]) {
+            std::FILE *f = std::fopen(filePath(part).c_str(), "rb");
+            if (!f) throw std::runtime_error("无法读取折半计数的溢出文件: " + filePath(part));
+            std::vector<HalfRecord> chunk(READ_CHUNK);
+            size_t got;
+            while ((got = std::fread(chunk.data(), sizeof(HalfRecord), chunk.size(), f)) > 0)
+                for (size_t i = 0; i < got; ++i) visit(chunk[i]);
+            std::fclose(f);
+        }
+        for (const HalfRecord &r : buffers[part]) visit(r);
+    }
+
+private:
+    std::string filePath(size_t part) const {
+        return (spillDir.path() / (tag + "-" + std::to_string(part) + ".bin")).string();
+    }
+
+    void spill() {
+        for (size_t part = 0; part < buffers.size(); ++part) {
+            std::vector<HalfRecord> &buf = buffers[part];
+            if (buf.empty()) continue;
+            std::FILE *f = std::fopen(filePath(part).c_str(), "ab");
+            if (!f) throw std::runtime_error("无法写入折半计数的溢出文件: " + filePath(part));
+            size_t written = std::fwrite(buf.data(), sizeof(HalfRecord), buf.size(), f);
+            if (std::fclose(f) != 0 || written != buf.size())
+                throw std::runtime_error("写入折半计数的溢出文件失败（磁盘已满？）: " + filePath(part));
+            onDisk[part] += buf.size();
+            spilledBytes += buf.size() * sizeof(HalfRecord);
+            buf.clear();
+            buf.shrink_to_fit();
+        }
+        buffered = 0;
+    }
+
+    std::vector<std::vector<HalfRecord>> buffers;
+    std::vector<size_t> onDisk;
+    size_t buffered = 0;
+    size_t budgetRecords;
+    uint64_t spilledBytes = 0;
+    SpillDirectory &spillDir;
+    std::string tag;
+};
+
+// 枚举 [row, endRow) 行的全部合法放法；ld/rd 为相对掩码，只负责本侧内部剪枝
+template <class Emit>
+void enumerateHalf(int n, int row, int endRow, uint32_t cols, uint32_t ld, uint32_t rd,
+                   uint64_t d1, uint64_t d2, uint32_t weight, uint64_t &nodes, Emit &emit) {
+    if (row == endRow) {
+        emit(HalfRecord{cols, weight, d1, d2});
+        return;
+    }
+    const uint32_t full = fullMask(n);
+    uint32_t avail = full & ~(cols | ld | rd);
+    if (row == 0) avail &= fullMask((n + 1) / 2);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        ++nodes;
+        int c = bitIndex(bit);
+        uint32_t w = weight;
+        if (row == 0) w = (n % 2 != 0 && c == n / 2) ? 1 : 2;
+        enumerateHalf(n, row + 1, endRow, cols | bit, (ld | bit) << 1, (rd | bit) >> 1,
+                      d1 | (1ull << (row + c)), d2 | (1ull << (row - c + n - 1)), w, nodes, emit);
+    }
+}
+
+} // namespace
+
+MeetInMiddleCounter::MeetInMiddleCounter(int n, MeetInMiddleOptions options) : n(n), options(options) {
+    if (n < 1 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+    this->options.partitions = std::max(1, this->options.partitions);
+    this->options.threads = std::max(1, this->options.threads);
+}
+
+CacheKey MeetInMiddleCounter::cacheKey() const {
+    CacheKey key;
+    key.engine = "mitm";
+    key.variant = "queens";
+    key.n = n;
+    key.engineVersion = ENGINE_VERSION;
+    return key;
+}
+
+CountResult MeetInMiddleCounter::count(ResultCache *cache, MeetInMiddleStats *stats) const {
+    CountResult result;
+    CacheEntry entry;
+    if (cache && cache->lookup(cacheKey(), {}, entry)) {
+        result.solutions = entry.solutions;
+        result.nodes = entry.nodes;
+        return result;
+    }
+
+    const int half = n / 2;
+    const uint32_t full = fullMask(n);
+    const int partitions = options.partitions;
+    size_t budgetRecords = options.memoryBudget / sizeof(HalfRecord) / 2;
+
+    SpillDirectory spillDir(options.spillDirectory);
+    PartitionStore tops(partitions, budgetRecords, spillDir, "top");
+    PartitionStore bottoms(partitions, budgetRecords, spillDir, "bottom");
+    MeetInMiddleStats local;
+
+    // 上半盘第 0 行只取左半并带对称权重；下半盘从第 half 行开始独立枚举
+    auto emitTop = [&](const HalfRecord &r) {
+        local.topHalves++;
+        tops.add(partitionOf(r.cols, partitions), r);
+    };
+    enumerateHalf(n, 0, half, 0, 0, 0, 0, 0, 1, result.nodes, emitTop);
+
+    auto emitBottom = [&](const HalfRecord &r) {
+        local.bottomHalves++;
+        bottoms.add(partitionOf(full ^ r.cols, partitions), r);
+    };
+    enumerateHalf(n, half, n, 0, 0, 0, 0, 0, 1, result.nodes, emitBottom);
+
+    // 已经溢出时其余记录也写入磁盘，连接阶段的内存只留给各线程的上半盘块
+    if (tops.spilled() || bottoms.spilled()) {
+        tops.flush();
+        bottoms.flush();
+    }
+    const int threads = std::min(options.threads, partitions);
+    const size_t chunkRecords = std::max(MIN_JOIN_RECORDS, options.memoryBudget / threads / JOIN_BYTES_PER_RECORD);
+
+    // 逐分区连接：上半盘按块载入、按列集合排序分组，每块流式扫描一遍下半盘探测互补列集合
+    std::vector<uint64_t> partSolutions(partitions, 0), partPairs(partitions, 0), partPasses(partitions, 0);
+    runParallel(threads, (size_t)partitions, [&](size_t p, int) {
+        uint64_t solutions = 0, pairs = 0;
+        std::unordered_map<uint32_t, std::pair<size_t, size_t>> ranges;
+        tops.scanChunks(p, chunkRecords, [&](std::vector<HalfRecord> &group) {
+            std::sort(group.begin(), group.end(),
+                      [](const HalfRecord &a, const HalfRecord &b) { return a.cols < b.cols; });
+            ranges.clear();
+            for (size_t i = 0; i < group.size();) {
+                size_t j = i;
+                while (j < group.size() && group[j].cols == group[i].cols) ++j;
+                ranges[group[i].cols] = {i, j};
+                i = j;
+            }
+
+            bottoms.scan(p, [&](const HalfRecord &b) {
+                auto it = ranges.find(full ^ b.cols);
+                if (it == ranges.end()) return;
+                for (size_t i = it->second.first; i < it->second.second; ++i) {
+                    const HalfRecord &t = group[i];
+                    pairs++;
+                    if (!(t.d1 & b.d1) && !(t.d2 & b.d2)) solutions += t.weight;
+                }
+            });
+            partPasses[p]++;
+        });
+        partSolutions[p] = solutions;
+        partPairs[p] = pairs;
+    });
+
+    for (int p = 0; p < partitions; ++p) {
+        result.solutions += partSolutions[p];
+        local.candidatePairs += partPairs[p];
+        local.joinPasses += partPasses[p];
+    }
+    local.spilled = tops.spilled() || bottoms.spilled();
+    local.spilledBytes = tops.bytesSpilled() + bottoms.bytesSpilled();
+    if (stats) *stats = local;
+    if (cache) cache->store(cacheKey(), {}, {result.solutions, result.nodes});
+    return result;
+}
+
+} // namespace Core
+} // namespace NQueens
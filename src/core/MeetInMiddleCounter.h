@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "NQueensCounter.h"
+#include "ResultCache.h"
+
+namespace NQueens {
+	namespace Core {
+
+		struct MeetInMiddleOptions {
+			int threads = 1;
+			int partitions = 64;                      // 按列集合哈希分区，连接时每次只处理一个分区
+			size_t memoryBudget = size_t(256) << 20;  // 半盘记录在内存中的上限，超出后各分区写入磁盘；
+			                                          // 连接阶段各线程载入的上半盘块合计也不超过它
+			std::string spillDirectory;               // 为空时使用系统临时目录
+		};
+
+		struct MeetInMiddleStats {
+			uint64_t topHalves = 0;
+			uint64_t bottomHalves = 0;
+			uint64_t candidatePairs = 0;   // 列集合互补、需要检查对角线的组合数
+			uint64_t joinPasses = 0;       // 连接时扫描下半盘分区的次数（每个上半盘块一次）
+			bool spilled = false;
+			uint64_t spilledBytes = 0;
+		};
+
+		// 折半计数：分别枚举上半盘（前 n/2 行）与下半盘，按所用列集合分桶，
+		// 对列集合互补的两半做哈希连接并检查对角线。以内存换节点数。
+		// 连接时上半盘分区按内存预算分块载入，每块流式扫描一遍对应的下半盘分区，内存占用与 N 无关。
+		class MeetInMiddleCounter {
+		public:
+			static constexpr uint32_t ENGINE_VERSION = 1;
+
+			explicit MeetInMiddleCounter(int n, MeetInMiddleOptions options = {});
+
+			// nodes 为两侧枚举半盘时访问的节点数
+			CountResult count(ResultCache *cache = nullptr, MeetInMiddleStats *stats = nullptr) const;
+
+			CacheKey cacheKey() const;
+
+		private:
+			int n;
+			MeetInMiddleOptions options;
+		};
+
+	} // namespace Core
+} // namespace NQueens
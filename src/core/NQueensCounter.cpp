@@ -0,0 +1,646 @@
+#include "NQueensCounter.h"
+#include "Bitops.h"
+#include "EndgameTable.h"
+#include "Parallel.h"
+#include "TreeEstimator.h"
+#include "WorkerMonitor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+// 计数内核的只读参数
+struct CountKernel {
+    uint32_t full;
+    const uint32_t *rowMask;      // 每行允许放置的列，无约束时全为 full
+    int endgameRow;               // 到达该行时改为查残局表，-1 表示不使用
+    const EndgameTable *endgame;
+};
+
+namespace {
+
+// 不做任何检查的默认钩子，内联后与手写循环等价
+struct PlainHooks {
+    uint64_t nodes = 0;
+    bool visit(int, uint32_t) { ++nodes; return true; }
+    void leave(int, uint32_t, uint64_t) {}
+    bool stopped() const { return false; }
+};
+
+// 在回溯时把子树解数累加到所放格子上：该格在这么多个解中放有皇后
+struct OccupancyHooks {
+    OccupancyHooks(int n, uint64_t *cells) : n(n), cells(cells) {}
+
+    bool visit(int, uint32_t) { ++nodes; return true; }
+    void leave(int row, uint32_t bit, uint64_t subtotal) { cells[row * n + bitIndex(bit)] += subtotal; }
+    bool stopped() const { return false; }
+
+    int n;
+    uint64_t *cells;
+    uint64_t nodes = 0;
+};
+
+// 位运算 DFS 计数内核，Hooks 决定节点计数、停止检查、逐格统计等附加行为
+template <class Hooks>
+uint64_t countFrom(const CountKernel &k, int row, uint32_t cols, uint32_t ld, uint32_t rd, Hooks &hooks) {
+    if (row == k.endgameRow) return k.endgame->completions(cols, ld, rd);
+    if (cols == k.full) return 1;
+    uint64_t total = 0;
+    uint32_t avail = k.rowMask[row] & ~(cols | ld | rd);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        if (!hooks.visit(row, bit)) break;
+        uint64_t subtotal = countFrom(k, row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1, hooks);
+        hooks.leave(row, bit, subtotal);
+        total += subtotal;
+        if (hooks.stopped()) break;
+    }
+    return total;
+}
+
+// 受控运行的共享状态：取消、节点预算与实时节点数
+struct RunControl {
+    const CancellationToken *token = nullptr;
+    uint64_t maxNodes = 0;
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<int> stop{-1}; // 停止原因（RunStatus），-1 表示继续
+
+    void requestStop(RunStatus status) {
+        int expected = -1;
+        stop.compare_exchange_strong(expected, (int)status);
+    }
+
+    bool poll(uint64_t newNodes) {
+        uint64_t total = nodes.fetch_add(newNodes, std::memory_order_relaxed) + newNodes;
+        if (token && token->isCancelled()) requestStop(RunStatus::Cancelled);
+        if (maxNodes && total >= maxNodes) requestStop(RunStatus::NodeLimit);
+        return stop.load(std::memory_order_relaxed) >= 0;
+    }
+};
+
+// 每 CHECK_INTERVAL 个节点汇报一次节点数并检查是否需要停止
+struct ControlledHooks {
+    static const uint64_t CHECK_INTERVAL = 1 << 14;
+
+    explicit ControlledHooks(RunControl &control) : control(control) {}
+
+    bool visit(int, uint32_t) {
+        if ((++nodes & (CHECK_INTERVAL - 1)) == 0) {
+            aborted = control.poll(nodes - reported);
+            reported = nodes;
+        }
+        return !aborted;
+    }
+    void leave(int, uint32_t, uint64_t) {}
+    bool stopped() const { return aborted; }
+
+    // 单元结束时补报剩余节点
+    void flush() {
+        control.nodes.fetch_add(nodes - reported, std::memory_order_relaxed);
+        reported = nodes;
+    }
+
+    RunControl &control;
+    uint64_t nodes = 0;
+    uint64_t reported = 0;
+    bool aborted = false;
+};
+
+// 在受控钩子的基础上记录当前路径，每到检查点时把部分棋盘发布到该线程的顺序锁槽
+struct LiveHooks : ControlledHooks {
+    LiveHooks(RunControl &control, WorkerMonitor &monitor, int worker, WorkerSnapshot &state, const WorkUnit &unit)
+        : ControlledHooks(control), monitor(monitor), worker(worker), state(state), unitRow((int)unit.prefix.size()),
+          baseNodes(state.nodes) {
+        for (int r = 0; r < unitRow; ++r) state.queens[r] = (int8_t)unit.prefix[r];
+        state.depth = unitRow;
+        state.active = true;
+        monitor.publish(worker, state);
+    }
+
+    bool visit(int row, uint32_t bit) {
+        path[row] = bit;
+        if ((++nodes & (CHECK_INTERVAL - 1)) == 0) {
+            publish(row + 1);
+            aborted = control.poll(nodes - reported);
+            reported = nodes;
+        }
+        return !aborted;
+    }
+
+    void publish(int depth) {
+        for (int r = unitRow; r < depth; ++r) state.queens[r] = (int8_t)bitIndex(path[r]);
+        state.depth = depth;
+        state.nodes = baseNodes + nodes;
+        monitor.publish(worker, state);
+    }
+
+    // 单元结束后计入解数，部分棋盘退回到单元前缀
+    void finish(uint64_t weightedSolutions, bool completed) {
+        state.nodes = baseNodes + nodes;
+        if (completed) {
+            state.solutions += weightedSolutions;
+            state.unitsDone++;
+        }
+        state.depth = unitRow;
+        monitor.publish(worker, state);
+    }
+
+    WorkerMonitor &monitor;
+    int worker;
+    WorkerSnapshot &state;
+    int unitRow;
+    uint64_t baseNodes;
+    uint32_t path[MAX_BOARD_SIZE];
+};
+
+template <class Visit>
+void enumerateFrom(uint32_t full, const uint32_t *rowMask, int row, uint32_t cols, uint32_t ld, uint32_t rd,
+                   std::vector<int> &queens, Visit &visit) {
+    if (cols == full) {
+        visit(queens);
+        return;
+    }
+    uint32_t avail = rowMask[row] & ~(cols | ld | rd);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        queens[row] = bitIndex(bit);
+        enumerateFrom(full, rowMask, row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1, queens, visit);
+    }
+    queens[row] = -1;
+}
+
+// mirror 为真时第 0 行只取左半，镜像解由权重 2 代表；有约束时左右不再对称，逐列展开
+void collectUnits(uint32_t full, const uint32_t *rowMask, bool mirror, int n, int depth, WorkUnit &cur,
+                  std::vector<WorkUnit> &out, uint64_t &nodes) {
+    int row = (int)cur.prefix.size();
+    if (row == depth || cur.cols == full) {
+        out.push_back(cur);
+        return;
+    }
+    uint32_t avail = rowMask[row] & ~(cur.cols | cur.ld | cur.rd);
+    if (row == 0 && mirror) avail &= fullMask((n + 1) / 2);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        ++nodes;
+        WorkUnit next;
+        next.prefix = cur.prefix;
+        next.prefix.push_back(bitIndex(bit));
+        next.cols = cur.cols | bit;
+        next.ld = (cur.ld | bit) << 1;
+        next.rd = (cur.rd | bit) >> 1;
+        next.weight = cur.weight;
+        if (row == 0 && mirror) next.weight = (n % 2 != 0 && next.prefix[0] == n / 2) ? 1 : 2;
+        collectUnits(full, rowMask, mirror, n, depth, next, out, nodes);
+    }
+}
+
+// 单线程不切分；多线程时由树规模估计决定切分深度，有约束时按约束后的树估计
+int splitDepthFor(int n, const std::vector<uint32_t> &rowMasks, int threads) {
+    return TreeEstimator(n, rowMasks).chooseSplitDepth(threads);
+}
+
+// 受控运行按至少这么多线程的规模切分工作单元
+const int MIN_CONTROLLED_SPLIT = 8;
+
+// 缓存子树小计的最大前缀深度（第 0 行、第 0/1 行）
+const int CACHED_PREFIX_DEPTH = 2;
+
+std::vector<int> truncated(const std::vector<int> &prefix, size_t len) {
+    return std::vector<int>(prefix.begin(), prefix.begin() + len);
+}
+
+// 按前缀汇总工作单元的结果，某个前缀下的全部单元完成后写入缓存
+class PrefixAggregator {
+public:
+    PrefixAggregator(ResultCache &cache, const CacheKey &key) : cache(cache), key(key) {}
+
+    void expect(const std::vector<int> &prefix) {
+        for (size_t d = 1; d <= std::min(prefix.size(), (size_t)CACHED_PREFIX_DEPTH); ++d)
+            groups[truncated(prefix, d)].remaining++;
+    }
+
+    // 已缓存的子前缀直接计入上层前缀的小计
+    void addCached(const std::vector<int> &prefix, const CacheEntry &entry) {
+        for (size_t d = 1; d < prefix.size(); ++d) {
+            Group &g = groups[truncated(prefix, d)];
+            g.total.solutions += entry.solutions;
+            g.total.nodes += entry.nodes;
+        }
+    }
+
+    void complete(const std::vector<int> &prefix, const CountResult &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t d = 1; d <= std::min(prefix.size(), (size_t)CACHED_PREFIX_DEPTH); ++d) {
+            std::vector<int> key = truncated(prefix, d);
+            Group &g = groups[key];
+            g.total.solutions += result.solutions;
+            g.total.nodes += result.nodes;
+            if (--g.remaining == 0) cache.store(this->key, key, g.total);
+        }
+    }
+
+private:
+    struct Group {
+        int remaining = 0;
+        CacheEntry total;
+    };
+
+    ResultCache &cache;
+    CacheKey key;
+    std::mutex mutex;
+    std::map<std::vector<int>, Group> groups;
+};
+
+} // namespace
+
+NQueensCounter::NQueensCounter(int n, int endgameDepth) : NQueensCounter(n, std::vector<int>(), endgameDepth) {}
+
+NQueensCounter::NQueensCounter(int n, const std::vector<int> &fixedColumns, int endgameDepth)
+    : n(n), fixed(fixedColumns) {
+    if (n < 1 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+    full = fullMask(n);
+    if (fixed.empty()) fixed.assign(n, -1);
+    if ((int)fixed.size() != n)
+        throw std::invalid_argument("约束的行数与棋盘大小不符");
+
+    // 每行允许的列：固定行只允许其列（与其他固定皇后冲突时为空），
+    // 其余行去掉被固定皇后攻击的格子——包括下方固定皇后向上的攻击，这是逐行掩码无法推出的
+    rowMasks.assign(n, full);
+    int lastFixedRow = -1;
+    for (int r = 0; r < n; ++r) {
+        int c = fixed[r];
+        if (c < -1 || c >= n)
+            throw std::invalid_argument("约束列号超出范围: " + std::to_string(c));
+        if (c < 0) continue;
+        lastFixedRow = r;
+        for (int i = 0; i < n; ++i) {
+            if (i == r) continue;
+            uint32_t attacked = 1u << c;
+            int d = i > r ? i - r : r - i;
+            if (c + d < n) attacked |= 1u << (c + d);
+            if (c - d >= 0) attacked |= 1u << (c - d);
+            rowMasks[i] &= ~attacked;
+        }
+    }
+    for (int r = 0; r < n; ++r) {
+        if (fixed[r] >= 0) rowMasks[r] &= 1u << fixed[r];
+    }
+    mirror = lastFixedRow < 0;
+
+    // 棋盘太小时残局表没有意义，直接关闭；残局表只看列与斜线，固定皇后落在最后几行时也不能使用
+    int depth = std::min(endgameDepth, (int)EndgameTable::MAX_DEPTH);
+    if (depth >= 2 && n > depth + 2 && lastFixedRow < n - depth)
+        endgame = std::make_shared<const EndgameTable>(n, depth);
+}
+
+CountKernel NQueensCounter::kernel() const {
+    CountKernel k;
+    k.full = full;
+    k.rowMask = rowMasks.data();
+    k.endgame = endgame.get();
+    k.endgameRow = endgame ? n - endgame->depth() : -1;
+    return k;
+}
+
+int NQueensCounter::endgameDepth() const {
+    return endgame ? endgame->depth() : 0;
+}
+
+std::vector<WorkUnit> NQueensCounter::split(int depth, uint64_t *prefixNodes) const {
+    std::vector<WorkUnit> units;
+    WorkUnit root;
+    uint64_t nodes = 0;
+    collectUnits(full, rowMasks.data(), mirror, n, std::max(1, std::min(depth, n)), root, units, nodes);
+    if (prefixNodes) *prefixNodes = nodes;
+    return units;
+}
+
+CacheKey NQueensCounter::cacheKey() const {
+    // 节点数随残局表深度变化，不同深度的结果分开缓存；解数相同，但条目同时记录两者
+    CacheKey key;
+    key.engine = "dfs-eg" + std::to_string(endgameDepth());
+    key.variant = "queens";
+    key.n = n;
+    if (!mirror) key.constraintHash = hashConstraints(fixed);
+    key.engineVersion = ENGINE_VERSION;
+    return key;
+}
+
+CountResult NQueensCounter::countUnit(const WorkUnit &unit) const {
+    PlainHooks hooks;
+    CountResult result;
+    result.solutions = countFrom(kernel(), (int)unit.prefix.size(), unit.cols, unit.ld, unit.rd, hooks);
+    result.nodes = hooks.nodes;
+    return result;
+}
+
+CountResult NQueensCounter::count(int threads, ResultCache *cache) const {
+    SearchOptions options;
+    options.threads = threads;
+    options.cache = cache;
+    SearchResult result = run(options, false);
+    CountResult total;
+    total.solutions = result.solutions;
+    total.nodes = result.nodes;
+    return total;
+}
+
+SearchResult NQueensCounter::search(const SearchOptions &options) const {
+    return run(options, true);
+}
+
+SearchResult NQueensCounter::run(const SearchOptions &options, bool controlled) const {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    SearchResult result;
+    ResultCache *cache = options.cache;
+    CacheKey key = cacheKey();
+    CacheEntry entry;
+    if (cache && cache->lookup(key, {}, entry)) {
+        result.solutions = entry.solutions;
+        result.nodes = entry.nodes;
+        result.fraction = 1.0;
+        return result;
+    }
+
+    // 受控运行切得更细，使取消/超时时有更多已完成的单元可以返回
+    int threads = std::max(1, options.threads);
+    int depth = splitDepthFor(n, rowMasks, controlled ? std::max(threads, MIN_CONTROLLED_SPLIT) : threads);
+    if (cache) depth = std::max(depth, std::min(n, CACHED_PREFIX_DEPTH));
+    std::vector<WorkUnit> units = split(depth, &result.nodes);
+    result.unitsTotal = units.size();
+
+    // 跳过已缓存前缀下的工作单元，每个已缓存前缀只计入一次
+    std::vector<size_t> pending;
+    std::unique_ptr<PrefixAggregator> aggregator;
+    if (cache) {
+        aggregator.reset(new PrefixAggregator(*cache, key));
+        std::map<std::vector<int>, bool> seen;
+        for (size_t i = 0; i < units.size(); ++i) {
+            const WorkUnit &unit = units[i];
+            bool skipped = false;
+            for (size_t d = 1; d <= std::min(unit.prefix.size(), (size_t)CACHED_PREFIX_DEPTH) && !skipped; ++d) {
+                std::vector<int> prefix = truncated(unit.prefix, d);
+                if (!cache->lookup(key, prefix, entry)) continue;
+                skipped = true;
+                if (seen[prefix]) break;
+                seen[prefix] = true;
+                result.solutions += entry.solutions * unit.weight;
+                result.nodes += entry.nodes;
+                aggregator->addCached(prefix, entry);
+            }
+            if (!skipped) {
+                aggregator->expect(unit.prefix);
+                pending.push_back(i);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < units.size(); ++i) pending.push_back(i);
+    }
+
+    // 进度模型：每个单元先用随机探测估计节点数，完成后替换为实际值
+    bool monitored = controlled && (options.onProgress || options.budget.timeLimit.count() > 0);
+    RunProgress progress;
+    if (monitored) {
+        TreeEstimator estimator(n, rowMasks);
+        std::vector<double> estimates;
+        // 使用残局表时只会访问到第 n-depth 行
+        int lastRow = n - endgameDepth();
+        for (size_t i : pending) {
+            TreeEstimate est = estimator.estimateUnit(units[i], 64);
+            double nodes = 1.0;
+            for (int d = (int)units[i].prefix.size() + 1; d <= lastRow; ++d) nodes += est.levelWidth[d];
+            estimates.push_back(nodes);
+        }
+        progress.reset(estimates);
+    }
+
+    RunControl control;
+    control.token = &options.token;
+    control.maxNodes = options.budget.maxNodes;
+    std::vector<CountResult> partial(pending.size());
+    std::vector<char> completed(pending.size(), 0);
+    std::atomic<uint64_t> liveSolutions{result.solutions};
+    const uint64_t baseNodes = result.nodes;
+
+    const CountKernel k = kernel();
+    auto runUnit = [&](size_t i, auto &hooks) {
+        const WorkUnit &unit = units[pending[i]];
+        CountResult r;
+        r.solutions = countFrom(k, (int)unit.prefix.size(), unit.cols, unit.ld, unit.rd, hooks);
+        r.nodes = hooks.nodes;
+        if (hooks.stopped()) return;
+        partial[i] = r;
+        completed[i] = 1;
+        liveSolutions += r.solutions * unit.weight;
+        if (monitored) progress.complete(i, (double)r.nodes);
+        if (aggregator) aggregator->complete(unit.prefix, r);
+    };
+
+    if (!controlled) {
+        runParallel(threads, pending.size(), [&](size_t i, int) {
+            PlainHooks hooks;
+            runUnit(i, hooks);
+        });
+    } else {
+        // 实时视图：每个工作线程维护自己的快照，只由该线程写入对应的槽
+        WorkerMonitor *live = options.workers;
+        std::vector<WorkerSnapshot> liveStates(live ? live->size() : 0);
+        if (live) {
+            live->reset(n);
+            for (WorkerSnapshot &state : liveStates) state.n = n;
+        }
+
+        auto work = [&](size_t i, int worker) {
+            if (control.stop.load(std::memory_order_relaxed) >= 0) return;
+            if (live && worker < live->size()) {
+                LiveHooks hooks(control, *live, worker, liveStates[worker], units[pending[i]]);
+                runUnit(i, hooks);
+                hooks.flush();
+                hooks.finish(partial[i].solutions * units[pending[i]].weight, completed[i] != 0);
+                return;
+            }
+            ControlledHooks hooks(control);
+            runUnit(i, hooks);
+            hooks.flush();
+        };
+        auto report = [&]() {
+            if (!options.onProgress) return;
+            SearchProgress p;
+            p.nodes = baseNodes + control.nodes.load(std::memory_order_relaxed);
+            p.solutions = liveSolutions.load();
+            p.fraction = progress.fraction();
+            p.elapsedSeconds = elapsed();
+            p.etaSeconds = progress.etaSeconds(p.elapsedSeconds);
+            options.onProgress(p);
+        };
+
+        if (!monitored) {
+            runParallel(threads, pending.size(), work);
+        } else {
+            runParallel(threads, pending.size(), work, [&](const auto &waitDone) {
+                const auto deadline = start + options.budget.timeLimit;
+                const bool limited = options.budget.timeLimit.count() > 0;
+                auto nextWait = [&]() {
+                    auto interval = std::max(options.progressInterval, std::chrono::milliseconds(1));
+                    if (!limited) return interval;
+                    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now());
+                    return std::max(std::chrono::milliseconds(1), std::min(interval, left));
+                };
+                while (!waitDone(nextWait())) {
+                    if (limited && std::chrono::steady_clock::now() >= deadline)
+                        control.requestStop(RunStatus::TimedOut);
+                    if (options.token.isCancelled()) control.requestStop(RunStatus::Cancelled);
+                    report();
+                }
+            });
+            result.fraction = progress.fraction();
+            report();
+        }
+        int stop = control.stop.load();
+        if (stop >= 0) result.status = (RunStatus)stop;
+        for (size_t w = 0; w < liveStates.size(); ++w) {
+            liveStates[w].active = false;
+            live->publish((int)w, liveStates[w]);
+        }
+    }
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (!completed[i]) continue;
+        result.solutions += partial[i].solutions * units[pending[i]].weight;
+        result.nodes += partial[i].nodes;
+    }
+    result.unitsDone = units.size() - pending.size() + std::count(completed.begin(), completed.end(), 1);
+    result.partial = result.status != RunStatus::Completed;
+    if (!result.partial) {
+        result.fraction = 1.0;
+    } else if (!monitored && !units.empty()) {
+        result.fraction = (double)result.unitsDone / units.size();
+    }
+    result.elapsedSeconds = elapsed();
+    if (cache && !result.partial) cache->store(key, {}, {result.solutions, result.nodes});
+    return result;
+}
+
+OccupancyMap NQueensCounter::occupancy(int threads) const {
+    threads = std::max(1, threads);
+    OccupancyMap map;
+    map.n = n;
+    std::vector<WorkUnit> units = split(splitDepthFor(n, rowMasks, threads), &map.nodes);
+    const size_t cellCount = (size_t)n * n;
+
+    // 残局表只给出完成数，不知道最后几行落在哪些格子，这里逐行搜索到底
+    CountKernel k = kernel();
+    k.endgameRow = -1;
+    k.endgame = nullptr;
+
+    // 每个工作线程一份计数表，最后合并；scratch 存放单个单元未乘权重的结果
+    struct WorkerState {
+        std::vector<uint64_t> cells, scratch;
+        uint64_t solutions = 0, nodes = 0;
+    };
+    std::vector<WorkerState> workers(threads);
+    for (WorkerState &w : workers) {
+        w.cells.assign(cellCount, 0);
+        w.scratch.assign(cellCount, 0);
+    }
+
+    runParallel(threads, units.size(), [&](size_t i, int worker) {
+        const WorkUnit &unit = units[i];
+        WorkerState &w = workers[worker];
+        OccupancyHooks hooks(n, w.scratch.data());
+        int row = (int)unit.prefix.size();
+        uint64_t subtotal = countFrom(k, row, unit.cols, unit.ld, unit.rd, hooks);
+        for (int r = 0; r < row; ++r) w.scratch[r * n + unit.prefix[r]] += subtotal;
+
+        // 权重为 2 的单元代表自身和左右镜像两组解
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                uint64_t &v = w.scratch[r * n + c];
+                if (!v) continue;
+                w.cells[r * n + c] += v;
+                if (unit.weight == 2) w.cells[r * n + (n - 1 - c)] += v;
+                v = 0;
+            }
+        }
+        w.solutions += subtotal * unit.weight;
+        w.nodes += hooks.nodes;
+    });
+
+    map.cells.assign(cellCount, 0);
+    for (const WorkerState &w : workers) {
+        for (size_t c = 0; c < cellCount; ++c) map.cells[c] += w.cells[c];
+        map.solutions += w.solutions;
+        map.nodes += w.nodes;
+    }
+    return map;
+}
+
+uint64_t NQueensCounter::enumerate(const SolutionSink &sink, int threads, size_t reorderWindow) const {
+    std::vector<WorkUnit> units = split(splitDepthFor(n, rowMasks, threads));
+    uint64_t emitted = 0;
+
+    // 单线程时边搜索边输出，不做缓存
+    if (threads <= 1) {
+        for (const WorkUnit &unit : units) {
+            std::vector<int> queens(n, -1);
+            std::copy(unit.prefix.begin(), unit.prefix.end(), queens.begin());
+            std::vector<int> mirror(n);
+            auto visit = [&](const std::vector<int> &q) {
+                sink(q);
+                ++emitted;
+                if (unit.weight == 2) {
+                    for (int r = 0; r < n; ++r) mirror[r] = (n - 1) - q[r];
+                    sink(mirror);
+                    ++emitted;
+                }
+            };
+            enumerateFrom(full, rowMasks.data(), (int)unit.prefix.size(), unit.cols, unit.ld, unit.rd, queens, visit);
+        }
+        return emitted;
+    }
+
+    // 多线程时每个单元的解（含镜像）按行首尾相接存入一块缓冲区，由调用线程按单元顺序写出
+    size_t window = reorderWindow ? reorderWindow : REORDER_WINDOW_PER_THREAD * (size_t)threads;
+    std::vector<int> out(n);
+    runOrdered<std::vector<int>>(threads, units.size(), window,
+        [&](size_t i, int) {
+            const WorkUnit &unit = units[i];
+            std::vector<int> queens(n, -1);
+            std::copy(unit.prefix.begin(), unit.prefix.end(), queens.begin());
+            std::vector<int> buffer;
+            auto visit = [&](const std::vector<int> &q) {
+                buffer.insert(buffer.end(), q.begin(), q.end());
+                if (unit.weight == 2)
+                    for (int c : q) buffer.push_back((n - 1) - c);
+            };
+            enumerateFrom(full, rowMasks.data(), (int)unit.prefix.size(), unit.cols, unit.ld, unit.rd, queens, visit);
+            return buffer;
+        },
+        [&](size_t, const std::vector<int> &buffer) {
+            for (size_t pos = 0; pos < buffer.size(); pos += n) {
+                std::copy(buffer.begin() + pos, buffer.begin() + pos + n, out.begin());
+                sink(out);
+                ++emitted;
+            }
+        });
+    return emitted;
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ResultCache.h"
+#include "SearchControl.h"
+
+namespace NQueens {
+	namespace Core {
+
+		struct CountResult {
+			uint64_t solutions = 0;
+			uint64_t nodes = 0;
+		};
+
+		// 搜索树上的一个前缀子问题
+		struct WorkUnit {
+			std::vector<int> prefix;
+			uint32_t cols = 0;
+			uint32_t ld = 0;
+			uint32_t rd = 0;
+			int weight = 1; // 对称性权重：镜像解可直接推导时为 2
+		};
+
+		// 各格子在全部解中放有皇后的次数（行优先）；第 0 行即解在第 0 行各列上的分布
+		struct OccupancyMap {
+			int n = 0;
+			uint64_t solutions = 0;
+			uint64_t nodes = 0;
+			std::vector<uint64_t> cells;
+
+			uint64_t at(int row, int col) const { return cells[(size_t)row * n + col]; }
+		};
+
+		using SolutionSink = std::function<void(const std::vector<int>&)>;
+
+		class EndgameTable;
+		struct CountKernel;
+
+		// 位运算计数/枚举引擎，不依赖 Qt
+		class NQueensCounter {
+		public:
+			// 计数结果的版本戳，搜索或计数语义变化时递增，使旧缓存失效
+			static constexpr uint32_t ENGINE_VERSION = 2;
+
+			// 默认用残局表直接给出最后几行的完成数
+			static constexpr int DEFAULT_ENDGAME_DEPTH = 3;
+
+			// endgameDepth 为 0 时关闭残局表，逐行搜索到底
+			explicit NQueensCounter(int n, int endgameDepth = DEFAULT_ENDGAME_DEPTH);
+
+			// 带约束的计数：fixedColumns[r] >= 0 表示第 r 行的皇后固定在该列，-1 表示自由。
+			// 结果为在这些固定皇后下的完成数；有约束时不再利用左右对称，缓存键带上约束哈希
+			NQueensCounter(int n, const std::vector<int> &fixedColumns, int endgameDepth = DEFAULT_ENDGAME_DEPTH);
+
+			// 统计解的个数（利用左右镜像对称只搜索一半）。
+			// 提供 cache 时先查最终结果，再按第 0 行、第 0/1 行前缀复用和写入子树小计。
+			CountResult count(int threads = 1, ResultCache *cache = nullptr) const;
+
+			// 受控计数：支持取消令牌、时间/节点预算和节流的进度回调，
+			// 预算耗尽或被取消时返回只含已完成工作单元的部分结果
+			SearchResult search(const SearchOptions &options) const;
+
+			// 统计单个子问题下的完整解个数（不乘对称权重）
+			CountResult countUnit(const WorkUnit &unit) const;
+
+			// 在计数的同时统计每个格子的占用次数，不生成任何解；
+			// 各线程独立累加后合并，镜像对称的单元同时计入镜像格子
+			OccupancyMap occupancy(int threads = 1) const;
+
+			// 枚举全部解，每个基础解之后紧跟其镜像解，与 NQueensSolver 的顺序一致。
+			// threads > 1 时各工作单元并行执行，按前缀顺序重排后在调用线程上交付，输出与单线程完全相同；
+			// reorderWindow 为暂存的工作单元数上限，0 表示线程数的 REORDER_WINDOW_PER_THREAD 倍
+			static constexpr size_t REORDER_WINDOW_PER_THREAD = 4;
+			uint64_t enumerate(const SolutionSink &sink, int threads = 1, size_t reorderWindow = 0) const;
+
+			// 在第 depth 行处切分搜索树，按前缀顺序返回工作单元；
+			// prefixNodes 非空时返回切分深度以上访问的节点数
+			std::vector<WorkUnit> split(int depth, uint64_t *prefixNodes = nullptr) const;
+
+			int size() const { return n; }
+			const std::vector<int> &constraints() const { return fixed; }
+			int endgameDepth() const;
+			CacheKey cacheKey() const;
+
+		private:
+			SearchResult run(const SearchOptions &options, bool controlled) const;
+			CountKernel kernel() const;
+
+			int n;
+			uint32_t full;
+			std::vector<int> fixed;
+			std::vector<uint32_t> rowMasks;
+			bool mirror;
+			std::shared_ptr<const EndgameTable> endgame;
+		};
+
+	} // namespace Core
+} // namespace NQueens
@@ -1,13 +1,14 @@
 #pragma once
-#include <QVector>
+#include <vector>
 #include "common/Types.h"
+#include "Generator.h"
 
 namespace NQueens {
 	namespace Core {
 
 		class NQueensSolver {
 		public:
-			explicit NQueensSolver(int n);
+			explicit NQueensSolver(int n, StepMode mode = StepMode::EveryColumn);
 
 			// 执行下一步搜索
 			SolverState nextStep();
@@ -16,17 +17,12 @@ namespace NQueens {
 			int getStepsCount() const;
 
 		private:
-			bool hasConflict(int r, int c) const;
-
 			int n;
-			QVector<int> queens;
-			QVector<int> history_col;
-			QVector<int> history_ld;
-			QVector<int> history_rd;
+			Generator<SolverState> trace;
+			Generator<SolverState>::iterator cursor;
+			bool started;
 			int solutionsFound;
 			int stepsCount;
-			int row;
-			int col;
 		};
 
 	} // namespace Core
@@ -0,0 +1,69 @@
+#include "PackedSolutions.h"
+#include "Bitops.h"
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+int columnBits(int n) {
+    int bits = 1;
+    while ((1 << bits) < n) ++bits;
+    return bits;
+}
+
+} // namespace
+
+PackedSolutions::PackedSolutions(int n) : n(n), bitsPerColumn(columnBits(n)) {
+    if (n < 0 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+}
+
+size_t PackedSolutions::bytesFor(int n, size_t count) {
+    return (count * (size_t)n * columnBits(n) + 63) / 64 * sizeof(uint64_t);
+}
+
+void PackedSolutions::append(const std::vector<int> &queens) {
+    if ((int)queens.size() != n)
+        throw std::invalid_argument("解的行数与棋盘大小不符");
+    size_t bit = count * (size_t)n * bitsPerColumn;
+    words.resize((bit + (size_t)n * bitsPerColumn + 63) / 64, 0);
+    for (int c : queens) {
+        uint64_t value = (uint64_t)c;
+        size_t word = bit / 64, offset = bit % 64;
+        words[word] |= value << offset;
+        if (offset + bitsPerColumn > 64) words[word + 1] |= value >> (64 - offset);
+        bit += bitsPerColumn;
+    }
+    ++count;
+}
+
+void PackedSolutions::clear() {
+    words.clear();
+    words.shrink_to_fit();
+    count = 0;
+}
+
+void PackedSolutions::unpack(size_t index, int *out) const {
+    const uint64_t mask = (1ull << bitsPerColumn) - 1;
+    size_t bit = index * (size_t)n * bitsPerColumn;
+    for (int r = 0; r < n; ++r) {
+        size_t word = bit / 64, offset = bit % 64;
+        uint64_t value = words[word] >> offset;
+        if (offset + bitsPerColumn > 64) value |= words[word + 1] << (64 - offset);
+        out[r] = (int)(value & mask);
+        bit += bitsPerColumn;
+    }
+}
+
+std::vector<int> PackedSolutions::at(size_t index) const {
+    if (index >= count) throw std::out_of_range("解序号越界: " + std::to_string(index));
+    std::vector<int> queens(n);
+    unpack(index, queens.data());
+    return queens;
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <string>
+#include <vector>
+#include "Trace.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 工作线程中第一个异常：记录后让其余线程不再领取新单元，join 之后在调用线程上重新抛出
+		class FirstError {
+		public:
+			void capture() {
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!error) error = std::current_exception();
+			}
+
+			void rethrow() {
+				if (error) std::rethrow_exception(error);
+			}
+
+		private:
+			std::mutex mutex;
+			std::exception_ptr error;
+		};
+
+		// 多个工作线程从共享下标中领取工作单元；work 抛出的异常在全部线程结束后由调用线程重新抛出
+		template <class Work>
+		void runParallel(int threads, size_t unitCount, Work work) {
+			threads = std::max(1, std::min<int>(threads, (int)unitCount));
+			if (threads == 1) {
+				for (size_t i = 0; i < unitCount; ++i) {
+					TraceScope scope("unit", "parallel", (int64_t)i);
+					work(i, 0);
+				}
+				return;
+			}
+			std::atomic<size_t> next{0};
+			FirstError error;
+			std::vector<std::thread> pool;
+			for (int t = 0; t < threads; ++t) {
+				pool.emplace_back([&, t]() {
+					Trace::setThreadName("worker " + std::to_string(t));
+					try {
+						for (size_t i = next++; i < unitCount; i = next++) {
+							TraceScope scope("unit", "parallel", (int64_t)i);
+							work(i, t);
+						}
+					} catch (...) {
+						error.capture();
+						next = unitCount;
+					}
+				});
+			}
+			for (auto &th : pool) th.join();
+			error.rethrow();
+		}
+
+		// 同上，但总是启动工作线程，调用线程在等待期间执行 monitor(waitDone)；
+		// waitDone(interval) 在全部工作完成时返回 true，超时返回 false
+		template <class Work, class Monitor>
+		void runParallel(int threads, size_t unitCount, Work work, Monitor monitor) {
+			threads = std::max(1, std::min<int>(threads, (int)std::max<size_t>(unitCount, 1)));
+			std::atomic<size_t> next{0};
+			int active = threads;
+			std::mutex mutex;
+			std::condition_variable finished;
+			FirstError error;
+
+			std::vector<std::thread> pool;
+			for (int t = 0; t < threads; ++t) {
+				pool.emplace_back([&, t]() {
+					Trace::setThreadName("worker " + std::to_string(t));
+					try {
+						for (size_t i = next++; i < unitCount; i = next++) {
+							TraceScope scope("unit", "parallel", (int64_t)i);
+							work(i, t);
+						}
+					} catch (...) {
+						error.capture();
+						next = unitCount;
+					}
+					std::lock_guard<std::mutex> lock(mutex);
+					if (--active == 0) finished.notify_all();
+				});
+			}
+			monitor([&](std::chrono::milliseconds interval) {
+				std::unique_lock<std::mutex> lock(mutex);
+				return finished.wait_for(lock, interval, [&]() { return active == 0; });
+			});
+			for (auto &th : pool) th.join();
+			error.rethrow();
+		}
+
+		// 按单元编号顺序交付结果：工作线程并行执行 produce(i, worker) 得到各单元的 Result，
+		// 调用线程按 0, 1, 2... 的顺序对其执行 consume(i, result)，consume 无需线程安全。
+		// 暂存的结果最多 window 个：领取的编号超前于待交付编号 window 个时工作线程等待，其余时候互不阻塞。
+		// produce 或 consume 抛出异常时唤醒所有等待的线程、停止领取与交付，join 之后重新抛出第一个异常
+		template <class Result, class Produce, class Consume>
+		void runOrdered(int threads, size_t unitCount, size_t window, Produce produce, Consume consume) {
+			threads = std::max(1, std::min<int>(threads, (int)std::max<size_t>(unitCount, 1)));
+			window = std::max<size_t>(window, 1);
+			if (threads == 1) {
+				for (size_t i = 0; i < unitCount; ++i) {
+					Result result;
+					{
+						TraceScope scope("unit", "parallel", (int64_t)i);
+						result = produce(i, 0);
+					}
+					TraceScope scope("emit", "parallel", (int64_t)i);
+					consume(i, result);
+				}
+				return;
+			}
+
+			std::mutex mutex;
+			std::condition_variable slotFreed;
+			std::condition_variable resultReady;
+			std::vector<std::optional<Result>> slots(window);
+			size_t claimed = 0;
+			size_t delivered = 0;
+			bool failed = false;
+			FirstError error;
+			auto fail = [&]() {
+				error.capture();
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					failed = true;
+				}
+				slotFreed.notify_all();
+				resultReady.notify_all();
+			};
+
+			std::vector<std::thread> pool;
+			for (int t = 0; t < threads; ++t) {
+				pool.emplace_back([&, t]() {
+					Trace::setThreadName("worker " + std::to_string(t));
+					for (;;) {
+						size_t i;
+						{
+							std::unique_lock<std::mutex> lock(mutex);
+							auto claimable = [&]() { return failed || claimed >= unitCount || claimed < delivered + window; };
+							if (!claimable()) {
+								TraceScope wait("window-full", "parallel");
+								slotFreed.wait(lock, claimable);
+							}
+							if (failed || claimed >= unitCount) return;
+							i = claimed++;
+						}
+						Result result;
+						try {
+							TraceScope scope("unit", "parallel", (int64_t)i);
+							result = produce(i, t);
+						} catch (...) {
+							fail();
+							return;
+						}
+						{
+							std::lock_guard<std::mutex> lock(mutex);
+							slots[i % window] = std::move(result);
+						}
+						resultReady.notify_one();
+					}
+				});
+			}
+
+			try {
+				for (size_t i = 0; i < unitCount; ++i) {
+					Result result;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						std::optional<Result> &slot = slots[i % window];
+						if (!slot.has_value() && !failed) {
+							TraceScope wait("reorder-wait", "parallel", (int64_t)i);
+							resultReady.wait(lock, [&]() { return failed || slot.has_value(); });
+						}
+						if (failed) break;
+						result = std::move(*slot);
+						slot.reset();
+						delivered = i + 1;
+					}
+					// 先腾出窗口再交付，写出与后续单元的计算重叠
+					slotFreed.notify_all();
+					TraceScope scope("emit", "parallel", (int64_t)i);
+					consume(i, result);
+				}
+			} catch (...) {
+				fail();
+			}
+			for (auto &th : pool) th.join();
+			error.rethrow();
+		}
+
+	} // namespace Core
+} // namespace NQueens
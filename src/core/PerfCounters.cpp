@@ -0,0 +1,129 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace NQueens {
+namespace Core {
+
+double PerfSample::ipc() const {
+    if (!has(PerfEvent::Cycles) || !has(PerfEvent::Instructions) || values[(int)PerfEvent::Cycles] == 0) return 0.0;
+    return double(values[(int)PerfEvent::Instructions]) / double(values[(int)PerfEvent::Cycles]);
+}
+
+double PerfSample::per(PerfEvent e, uint64_t units) const {
+    if (!has(e) || units == 0) return -1.0;
+    return double(values[(int)e]) / double(units);
+}
+
+const char *PerfCounters::name(PerfEvent e) {
+    static const char *NAMES[PerfSample::EVENTS] = {"cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"};
+    return NAMES[(int)e];
+}
+
+#ifdef __linux__
+
+namespace {
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig EVENT_CONFIGS[PerfSample::EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+int openEvent(const EventConfig &event, bool inherit) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.inherit = inherit ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // 计数器多于硬件寄存器时内核分时复用，按启用/实际运行时间换算
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+} // namespace
+
+PerfCounters::PerfCounters(bool inheritThreads) {
+    for (int i = 0; i < PerfSample::EVENTS; ++i) {
+        fds[i] = openEvent(EVENT_CONFIGS[i], inheritThreads);
+        if (fds[i] < 0 && message.empty()) {
+            message = std::string(name((PerfEvent)i)) + ": " + std::strerror(errno);
+            if (errno == EACCES || errno == EPERM)
+                message += "（检查 /proc/sys/kernel/perf_event_paranoid）";
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds)
+        if (fd >= 0) close(fd);
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds)
+        if (fd >= 0) return true;
+    return false;
+}
+
+void PerfCounters::start() {
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+    for (int fd : fds)
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    for (int i = 0; i < PerfSample::EVENTS; ++i) {
+        uint64_t data[3];  // 值、启用时间、运行时间
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        if (data[2] == 0) continue;  // 从未被调度到硬件上
+        sample.values[i] = data[2] < data[1] ? uint64_t(double(data[0]) * data[1] / data[2]) : data[0];
+        sample.valid[i] = true;
+    }
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters(bool) : message("当前平台不支持硬件性能计数器") {
+    fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::available() const {
+    return false;
+}
+
+void PerfCounters::start() {}
+
+PerfSample PerfCounters::stop() {
+    return PerfSample();
+}
+
+#endif
+
+} // namespace Core
+} // namespace NQueens
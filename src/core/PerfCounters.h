@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace NQueens {
+	namespace Core {
+
+		enum class PerfEvent { Cycles, Instructions, BranchMisses, L1dMisses, LlcMisses, COUNT };
+
+		// 一段区间内各硬件计数器的读数；某个计数器未能打开时对应项无效
+		struct PerfSample {
+			static constexpr int EVENTS = (int)PerfEvent::COUNT;
+
+			std::array<uint64_t, EVENTS> values{};
+			std::array<bool, EVENTS> valid{};
+
+			bool has(PerfEvent e) const { return valid[(int)e]; }
+			uint64_t operator[](PerfEvent e) const { return values[(int)e]; }
+
+			// 每周期指令数；周期或指令计数不可用时为 0
+			double ipc() const;
+			// 按 units（节点数、帧数等）平均；不可用时为 -1
+			double per(PerfEvent e, uint64_t units) const;
+		};
+
+		// Linux perf_event_open 硬件计数器，只统计用户态。
+		// 其他平台或权限不足（perf_event_paranoid、容器限制）时 available() 为 false，
+		// start/stop 照常可调用，stop 返回全部无效的读数，调用方据此省略相关输出。
+		// inheritThreads 为 true 时一并统计 start 之后创建的线程，线程退出后计入读数
+		class PerfCounters {
+		public:
+			explicit PerfCounters(bool inheritThreads = false);
+			~PerfCounters();
+			PerfCounters(const PerfCounters &) = delete;
+			PerfCounters &operator=(const PerfCounters &) = delete;
+
+			bool available() const;
+			// 不可用或部分计数器打不开时的原因
+			const std::string &error() const { return message; }
+
+			void start();
+			PerfSample stop();
+
+			static const char *name(PerfEvent e);
+
+		private:
+			std::array<int, PerfSample::EVENTS> fds;
+			std::string message;
+		};
+
+	} // namespace Core
+} // namespace NQueens
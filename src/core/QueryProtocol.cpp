@@ -0,0 +1,194 @@
+#include "QueryProtocol.h"
+#include "Bitops.h"
+#include <stdexcept>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+void putInt(std::string &out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(char((value >> (8 * i)) & 0xFF));
+}
+
+// 顺序读取负载，越界时抛出异常
+class Reader {
+public:
+    explicit Reader(const std::string &data) : data(data) {}
+
+    uint64_t take(int bytes) {
+        if (pos + bytes > data.size()) throw std::invalid_argument("查询消息过短");
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) value |= uint64_t((unsigned char)data[pos + i]) << (8 * i);
+        pos += bytes;
+        return value;
+    }
+
+    std::string rest() {
+        std::string tail = data.substr(pos);
+        pos = data.size();
+        return tail;
+    }
+
+    void finish() const {
+        if (pos != data.size()) throw std::invalid_argument("查询消息末尾有多余数据");
+    }
+
+private:
+    const std::string &data;
+    size_t pos = 0;
+};
+
+void checkBoard(int n) {
+    if (n < 1 || n > MAX_BOARD_SIZE) throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+}
+
+} // namespace
+
+std::string encodeRequest(const QueryRequest &request) {
+    checkBoard(request.n);
+    std::string out;
+    putInt(out, QUERY_PROTOCOL_VERSION, 1);
+    putInt(out, (uint8_t)request.op, 1);
+    putInt(out, request.n, 1);
+    switch (request.op) {
+    case QueryOp::Count: {
+        std::string pairs;
+        int k = 0;
+        for (size_t row = 0; row < request.fixed.size(); ++row) {
+            if (request.fixed[row] < 0) continue;
+            putInt(pairs, row, 1);
+            putInt(pairs, request.fixed[row], 1);
+            ++k;
+        }
+        putInt(out, k, 1);
+        out += pairs;
+        break;
+    }
+    case QueryOp::Enumerate:
+        putInt(out, request.index, 8);
+        putInt(out, request.count, 4);
+        break;
+    case QueryOp::Unrank:
+        putInt(out, request.index, 8);
+        break;
+    case QueryOp::Rank:
+        if ((int)request.queens.size() != request.n) throw std::invalid_argument("解的行数与棋盘大小不符");
+        for (int c : request.queens) putInt(out, c, 1);
+        break;
+    }
+    return out;
+}
+
+QueryRequest decodeRequest(const std::string &payload) {
+    Reader in(payload);
+    if (in.take(1) != QUERY_PROTOCOL_VERSION) throw std::invalid_argument("不支持的查询协议版本");
+    QueryRequest request;
+    uint64_t op = in.take(1);
+    request.n = (int)in.take(1);
+    checkBoard(request.n);
+    switch (op) {
+    case (uint8_t)QueryOp::Count: {
+        request.op = QueryOp::Count;
+        int k = (int)in.take(1);
+        if (k > 0) request.fixed.assign(request.n, -1);
+        for (int i = 0; i < k; ++i) {
+            int row = (int)in.take(1), col = (int)in.take(1);
+            if (row >= request.n || col >= request.n) throw std::invalid_argument("固定皇后超出棋盘");
+            request.fixed[row] = col;
+        }
+        break;
+    }
+    case (uint8_t)QueryOp::Enumerate:
+        request.op = QueryOp::Enumerate;
+        request.index = in.take(8);
+        request.count = (uint32_t)in.take(4);
+        if (request.count > QUERY_MAX_ENUMERATE)
+            throw std::invalid_argument("一次最多取 " + std::to_string(QUERY_MAX_ENUMERATE) + " 个解");
+        break;
+    case (uint8_t)QueryOp::Unrank:
+        request.op = QueryOp::Unrank;
+        request.index = in.take(8);
+        break;
+    case (uint8_t)QueryOp::Rank:
+        request.op = QueryOp::Rank;
+        for (int row = 0; row < request.n; ++row) request.queens.push_back((int)in.take(1));
+        break;
+    default:
+        throw std::invalid_argument("未知的查询操作: " + std::to_string(op));
+    }
+    in.finish();
+    return request;
+}
+
+std::string encodeResponse(const QueryRequest &request, const QueryResponse &response) {
+    std::string out;
+    if (!response.ok) {
+        putInt(out, 1, 1);
+        return out + response.error;
+    }
+    putInt(out, 0, 1);
+    switch (request.op) {
+    case QueryOp::Count:
+        putInt(out, response.solutions, 8);
+        putInt(out, response.nodes, 8);
+        break;
+    case QueryOp::Enumerate:
+    case QueryOp::Unrank:
+        putInt(out, response.boards.size(), 4);
+        for (const std::vector<int> &board : response.boards)
+            for (int c : board) putInt(out, c, 1);
+        break;
+    case QueryOp::Rank:
+        putInt(out, response.index, 8);
+        break;
+    }
+    return out;
+}
+
+QueryResponse decodeResponse(const QueryRequest &request, const std::string &payload) {
+    Reader in(payload);
+    QueryResponse response;
+    if (in.take(1) != 0) {
+        response.ok = false;
+        response.error = in.rest();
+        return response;
+    }
+    switch (request.op) {
+    case QueryOp::Count:
+        response.solutions = in.take(8);
+        response.nodes = in.take(8);
+        break;
+    case QueryOp::Enumerate:
+    case QueryOp::Unrank: {
+        uint64_t m = in.take(4);
+        for (uint64_t i = 0; i < m; ++i) {
+            std::vector<int> board(request.n);
+            for (int &c : board) c = (int)in.take(1);
+            response.boards.push_back(std::move(board));
+        }
+        break;
+    }
+    case QueryOp::Rank:
+        response.index = in.take(8);
+        break;
+    }
+    in.finish();
+    return response;
+}
+
+std::string queryFrame(const std::string &payload) {
+    if (payload.size() > QUERY_MAX_FRAME) throw std::length_error("查询消息过长");
+    std::string out;
+    putInt(out, payload.size(), 4);
+    return out + payload;
+}
+
+uint32_t queryFrameLength(const char *header) {
+    uint32_t length = 0;
+    for (int i = 0; i < 4; ++i) length |= uint32_t((unsigned char)header[i]) << (8 * i);
+    return length;
+}
+
+} // namespace Core
+} // namespace NQueens
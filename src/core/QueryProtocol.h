@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NQueens {
+	namespace Core {
+
+		// 查询服务（nqueens-cli serve）的二进制协议，服务端与客户端共用。
+		// 每个消息为一帧：4 字节小端负载长度 + 负载。同一连接上的请求按顺序应答。
+		//
+		// 请求负载：u8 版本(=1)  u8 操作  u8 N，随后按操作：
+		//   Count      u8 k，k 组 (u8 行, u8 列)   —— 固定皇后下的完成数，k=0 即总解数
+		//   Enumerate  u64 起始序号，u32 个数      —— 按字典序取一段解
+		//   Unrank     u64 序号
+		//   Rank       N 个 u8 列号
+		// 应答负载：u8 状态（0 成功，1 失败），失败时其余为 UTF-8 错误信息；成功时按操作：
+		//   Count      u64 解数，u64 节点数
+		//   Enumerate / Unrank   u32 解的个数 m，m*N 个 u8 列号
+		//   Rank       u64 序号
+		enum class QueryOp : uint8_t { Count = 1, Enumerate = 2, Unrank = 3, Rank = 4 };
+
+		constexpr uint8_t QUERY_PROTOCOL_VERSION = 1;
+		constexpr size_t QUERY_FRAME_HEADER = 4;
+		constexpr uint32_t QUERY_MAX_FRAME = 64u << 20;
+		constexpr uint32_t QUERY_MAX_ENUMERATE = 1u << 20;
+
+		struct QueryRequest {
+			QueryOp op = QueryOp::Count;
+			int n = 8;
+			std::vector<int> fixed;   // Count：每行固定的列号，-1 表示自由；为空表示无约束
+			uint64_t index = 0;       // Enumerate 的起始序号 / Unrank 的序号
+			uint32_t count = 1;       // Enumerate 的个数
+			std::vector<int> queens;  // Rank
+		};
+
+		struct QueryResponse {
+			bool ok = true;
+			std::string error;
+			uint64_t solutions = 0;
+			uint64_t nodes = 0;
+			uint64_t index = 0;
+			std::vector<std::vector<int>> boards;
+		};
+
+		// 编码结果是规范的：约束按行排列，内容相同的请求得到相同的字节串
+		std::string encodeRequest(const QueryRequest &request);
+		std::string encodeResponse(const QueryRequest &request, const QueryResponse &response);
+
+		// 负载格式不合法时抛出 std::invalid_argument
+		QueryRequest decodeRequest(const std::string &payload);
+		QueryResponse decodeResponse(const QueryRequest &request, const std::string &payload);
+
+		// 加上帧头；解析帧头得到负载长度
+		std::string queryFrame(const std::string &payload);
+		uint32_t queryFrameLength(const char *header);
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,177 @@
+#include "RectangularCounter.h"
+#include "Bitops.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 搜索树上的一个子问题：从第 row 行开始，已放 placed 个皇后
+struct RectUnit {
+    int row;
+    int placed;
+    uint32_t cols;
+    uint32_t ld;
+    uint32_t rd;
+    uint64_t weight;
+};
+
+struct RectSearch {
+    int height;
+    int k;
+    uint32_t full;
+    uint64_t nodes = 0;
+
+    // 每一行要么留空，要么在可放的列上放一个皇后；剩余行数不够放完时剪枝
+    uint64_t countFrom(int row, int placed, uint32_t cols, uint32_t ld, uint32_t rd) {
+        if (placed == k) return 1;
+        int need = k - placed;
+        int left = height - row;
+        if (left < need || popCount(full & ~cols) < need) return 0;
+
+        uint64_t total = 0;
+        if (left > need) total += countFrom(row + 1, placed, cols, ld << 1, rd >> 1);
+        uint32_t avail = full & ~(cols | ld | rd);
+        while (avail) {
+            uint32_t bit = lowestBit(avail);
+            avail ^= bit;
+            nodes++;
+            total += countFrom(row + 1, placed + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1);
+        }
+        return total;
+    }
+};
+
+// 第一个皇后所在的行与列（只取左半）构成初始单元，之后整体向下展开若干行直到单元数足够
+std::vector<RectUnit> splitUnits(int height, int width, int k, int threads, uint64_t &nodes) {
+    std::vector<RectUnit> units;
+    for (int r = 0; r + k <= height; ++r) {
+        for (int c = 0; c < (width + 1) / 2; ++c) {
+            uint32_t bit = 1u << c;
+            uint64_t weight = (width % 2 != 0 && c == width / 2) ? 1 : 2;
+            units.push_back({r + 1, 1, bit, bit << 1, bit >> 1, weight});
+            nodes++;
+        }
+    }
+
+    const size_t target = threads > 1 ? (size_t)threads * 16 : 0;
+    const uint32_t full = fullMask(width);
+    for (int level = 0; level < 4 && units.size() < target; ++level) {
+        std::vector<RectUnit> next;
+        for (const RectUnit &u : units) {
+            int need = k - u.placed;
+            int left = height - u.row;
+            if (need == 0 || left < need) {
+                next.push_back(u);
+                continue;
+            }
+            if (left > need) next.push_back({u.row + 1, u.placed, u.cols, u.ld << 1, u.rd >> 1, u.weight});
+            uint32_t avail = full & ~(u.cols | u.ld | u.rd);
+            while (avail) {
+                uint32_t bit = lowestBit(avail);
+                avail ^= bit;
+                nodes++;
+                next.push_back({u.row + 1, u.placed + 1, u.cols | bit, (u.ld | bit) << 1, (u.rd | bit) >> 1, u.weight});
+            }
+        }
+        units.swap(next);
+    }
+    return units;
+}
+
+void checkDimensions(int rows, int cols) {
+    if (rows < 1 || rows > MAX_BOARD_SIZE || cols < 1 || cols > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘尺寸超出范围: " + std::to_string(rows) + "x" + std::to_string(cols));
+}
+
+} // namespace
+
+RectangularCounter::RectangularCounter(int rows, int cols, int queens)
+    : height(std::min(rows, cols)), width(std::max(rows, cols)), k(queens) {
+    checkDimensions(rows, cols);
+    if (queens < 0) throw std::invalid_argument("皇后数不能为负: " + std::to_string(queens));
+}
+
+CacheKey RectangularCounter::cacheKey() const {
+    CacheKey key;
+    key.engine = "rect";
+    key.variant = "rect-w" + std::to_string(width) + "-k" + std::to_string(k);
+    key.n = height;
+    key.engineVersion = ENGINE_VERSION;
+    return key;
+}
+
+CountResult RectangularCounter::count(int threads, ResultCache *cache) const {
+    CountResult result;
+    CacheEntry entry;
+    if (cache && cache->lookup(cacheKey(), {}, entry)) {
+        result.solutions = entry.solutions;
+        result.nodes = entry.nodes;
+        return result;
+    }
+
+    if (k == 0) {
+        result.solutions = 1;
+    } else if (k <= height) {
+        std::vector<RectUnit> units = splitUnits(height, width, k, threads, result.nodes);
+        std::vector<uint64_t> solutions(units.size());
+        std::vector<uint64_t> nodes(units.size());
+        runParallel(threads, units.size(), [&](size_t i, int) {
+            const RectUnit &u = units[i];
+            RectSearch search{height, k, fullMask(width)};
+            solutions[i] = u.weight * search.countFrom(u.row, u.placed, u.cols, u.ld, u.rd);
+            nodes[i] = search.nodes;
+        });
+        for (size_t i = 0; i < units.size(); ++i) {
+            result.solutions += solutions[i];
+            result.nodes += nodes[i];
+        }
+    }
+
+    if (cache) cache->store(cacheKey(), {}, {result.solutions, result.nodes});
+    return result;
+}
+
+uint64_t RectangularCounter::bruteForce(int rows, int cols, int queens) {
+    checkDimensions(rows, cols);
+    if (rows * cols > BRUTE_FORCE_CELLS)
+        throw std::invalid_argument("棋盘过大，不适合穷举: " + std::to_string(rows) + "x" + std::to_string(cols));
+    if (queens < 0) throw std::invalid_argument("皇后数不能为负: " + std::to_string(queens));
+
+    const int cells = rows * cols;
+    std::vector<int> chosen;
+    uint64_t total = 0;
+    auto attacks = [cols](int a, int b) {
+        int ra = a / cols, ca = a % cols, rb = b / cols, cb = b % cols;
+        return ra == rb || ca == cb || ra - ca == rb - cb || ra + ca == rb + cb;
+    };
+    // 按格子编号递增选取，每个组合恰好访问一次
+    auto choose = [&](auto &self, int from) -> void {
+        if ((int)chosen.size() == queens) {
+            total++;
+            return;
+        }
+        for (int cell = from; cell <= cells - (queens - (int)chosen.size()); ++cell) {
+            bool safe = true;
+            for (int other : chosen)
+                if (attacks(cell, other)) {
+                    safe = false;
+                    break;
+                }
+            if (!safe) continue;
+            chosen.push_back(cell);
+            self(self, cell + 1);
+            chosen.pop_back();
+        }
+    };
+    choose(choose, 0);
+    return total;
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include "NQueensCounter.h"
+#include "ResultCache.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// M×N 棋盘上放 k 个互不攻击的皇后的方案数。
+		// 皇后的攻击关系在转置下不变，内部总是让行数不超过列数，行数多于 k 时每行可以留空。
+		// 对称性只用左右翻转：第一个皇后（最上方有皇后的一行）只放左半，镜像方案直接计入
+		class RectangularCounter {
+		public:
+			static constexpr uint32_t ENGINE_VERSION = 1;
+
+			RectangularCounter(int rows, int cols, int queens);
+
+			int rows() const { return height; }
+			int cols() const { return width; }
+			int queens() const { return k; }
+
+			// nodes 为放下的皇后数（含切分阶段）
+			CountResult count(int threads = 1, ResultCache *cache = nullptr) const;
+
+			CacheKey cacheKey() const;
+
+			// 按行优先枚举 k 个格子的组合并两两检查攻击，与位运算内核完全独立，
+			// 只用于小棋盘上的交叉校验（格子数不超过 BRUTE_FORCE_CELLS）
+			static constexpr int BRUTE_FORCE_CELLS = 64;
+			static uint64_t bruteForce(int rows, int cols, int queens);
+
+		private:
+			int height;  // 转置后 height <= width
+			int width;
+			int k;
+		};
+
+	} // namespace Core
+} // namespace NQueens
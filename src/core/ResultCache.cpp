@@ -0,0 +1,119 @@
+#include "ResultCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+const char *HEADER_TAG = "nqueens-cache";
+
+std::string prefixText(const std::vector<int> &prefix) {
+    if (prefix.empty()) return "*";
+    std::string text;
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (i) text += ',';
+        text += std::to_string(prefix[i]);
+    }
+    return text;
+}
+
+std::string headerLine(const CacheKey &key) {
+    return std::string(HEADER_TAG) + " engine=" + std::to_string(key.engineVersion);
+}
+
+} // namespace
+
+uint64_t hashConstraints(const std::vector<int> &values) {
+    if (values.empty()) return 0;
+    uint64_t h = 1469598103934665603ull;
+    for (int v : values) {
+        for (int i = 0; i < 4; ++i) {
+            h ^= (uint64_t)((uint32_t)v >> (i * 8)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    }
+    return h;
+}
+
+ResultCache::ResultCache(std::string directory) : directory(std::move(directory)) {
+    if (!this->directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(this->directory, ec);
+    }
+}
+
+std::string ResultCache::tableName(const CacheKey &key) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)key.constraintHash);
+    return key.variant + "_n" + std::to_string(key.n) + "_" + hash + "." + key.engine;
+}
+
+std::string ResultCache::filePath(const CacheKey &key) const {
+    return (std::filesystem::path(directory) / (tableName(key) + ".cache")).string();
+}
+
+ResultCache::Table &ResultCache::table(const CacheKey &key) {
+    std::string name = tableName(key) + "@" + std::to_string(key.engineVersion);
+    auto it = tables.find(name);
+    if (it != tables.end()) return it->second;
+
+    Table &t = tables[name];
+    if (directory.empty()) return t;
+
+    std::ifstream in(filePath(key));
+    if (!in) return t;
+
+    // 引擎版本不一致时整个文件作废，下次写入时重建
+    std::string line;
+    if (!std::getline(in, line) || line != headerLine(key)) {
+        in.close();
+        std::remove(filePath(key).c_str());
+        return t;
+    }
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string prefix;
+        CacheEntry entry;
+        if (fields >> prefix >> entry.solutions >> entry.nodes) t[prefix] = entry;
+    }
+    return t;
+}
+
+bool ResultCache::lookup(const CacheKey &key, const std::vector<int> &prefix, CacheEntry &entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Table &t = table(key);
+    auto it = t.find(prefixText(prefix));
+    if (it == t.end()) return false;
+    entry = it->second;
+    return true;
+}
+
+void ResultCache::store(const CacheKey &key, const std::vector<int> &prefix, const CacheEntry &entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Table &t = table(key);
+    std::string text = prefixText(prefix);
+    auto it = t.find(text);
+    if (it != t.end() && it->second.solutions == entry.solutions && it->second.nodes == entry.nodes) return;
+    t[text] = entry;
+
+    if (directory.empty()) return;
+    std::string path = filePath(key);
+    bool fresh = !std::filesystem::exists(path);
+    std::ofstream out(path, std::ios::app);
+    if (!out) return;
+    if (fresh) out << headerLine(key) << '\n';
+    out << text << '\t' << entry.solutions << '\t' << entry.nodes << '\n';
+}
+
+void ResultCache::clear(const CacheKey &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tables.erase(tableName(key) + "@" + std::to_string(key.engineVersion));
+    if (!directory.empty()) std::remove(filePath(key).c_str());
+}
+
+} // namespace Core
+} // namespace NQueens
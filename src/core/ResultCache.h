@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NQueens {
+	namespace Core {
+
+		// 缓存键：问题变体 + 棋盘大小 + 约束哈希；engine/engineVersion 标明产生结果的计数引擎，
+		// 版本不符的条目整体作废
+		struct CacheKey {
+			std::string engine = "dfs";
+			std::string variant;
+			int n = 0;
+			uint64_t constraintHash = 0;
+			uint32_t engineVersion = 0;
+		};
+
+		struct CacheEntry {
+			uint64_t solutions = 0;
+			uint64_t nodes = 0;
+		};
+
+		// 约束哈希（FNV-1a），无约束时为 0
+		uint64_t hashConstraints(const std::vector<int> &values);
+
+		// 以前缀为粒度持久化计数结果：空前缀为最终结果，其余为该前缀下的子树解数。
+		// directory 为空时只在内存中缓存。
+		class ResultCache {
+		public:
+			explicit ResultCache(std::string directory = "");
+
+			bool lookup(const CacheKey &key, const std::vector<int> &prefix, CacheEntry &entry);
+			void store(const CacheKey &key, const std::vector<int> &prefix, const CacheEntry &entry);
+
+			// 删除某个键下的全部条目（包括磁盘文件）
+			void clear(const CacheKey &key);
+
+			const std::string &location() const { return directory; }
+
+		private:
+			using Table = std::unordered_map<std::string, CacheEntry>;
+
+			Table &table(const CacheKey &key);
+			std::string filePath(const CacheKey &key) const;
+			static std::string tableName(const CacheKey &key);
+
+			std::string directory;
+			std::mutex mutex;
+			std::unordered_map<std::string, Table> tables;
+		};
+
+	} // namespace Core
+} // namespace NQueens
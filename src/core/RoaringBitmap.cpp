@@ -0,0 +1,185 @@
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+const size_t BITMAP_WORDS = 65536 / 64;
+
+// 数组长度相差超过这个倍数时，短的一方逐个在长的一方里二分查找
+const size_t GALLOP_RATIO = 32;
+
+bool testBit(const std::vector<uint64_t> &bits, uint16_t low) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+} // namespace
+
+void RoaringBitmap::append(uint32_t value) {
+    if (!containers.empty() && value <= last)
+        throw std::invalid_argument("位图追加的值必须递增: " + std::to_string(value));
+    last = value;
+    uint16_t key = uint16_t(value >> 16), low = uint16_t(value);
+    if (containers.empty() || containers.back().key != key) {
+        containers.emplace_back();
+        containers.back().key = key;
+    }
+
+    Container &c = containers.back();
+    c.cardinality++;
+    if (c.bits.empty()) {
+        if (c.values.size() < ARRAY_LIMIT) {
+            c.values.push_back(low);
+            return;
+        }
+        // 数组已满，转为位图
+        c.bits.assign(BITMAP_WORDS, 0);
+        for (uint16_t v : c.values) c.bits[v >> 6] |= 1ull << (v & 63);
+        std::vector<uint16_t>().swap(c.values);
+    }
+    c.bits[low >> 6] |= 1ull << (low & 63);
+}
+
+RoaringBitmap RoaringBitmap::range(uint32_t count) {
+    RoaringBitmap result;
+    for (uint32_t start = 0; start < count; start += 65536) {
+        uint32_t size = std::min<uint32_t>(65536, count - start);
+        Container c;
+        c.key = uint16_t(start >> 16);
+        c.cardinality = size;
+        if (size <= ARRAY_LIMIT) {
+            c.values.resize(size);
+            for (uint32_t v = 0; v < size; ++v) c.values[v] = uint16_t(v);
+        } else {
+            c.bits.assign(BITMAP_WORDS, 0);
+            for (uint32_t w = 0; w < size / 64; ++w) c.bits[w] = ~0ull;
+            if (size % 64) c.bits[size / 64] = (1ull << (size % 64)) - 1;
+        }
+        result.containers.push_back(std::move(c));
+        result.last = start + size - 1;
+    }
+    return result;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    uint16_t key = uint16_t(value >> 16), low = uint16_t(value);
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container &c, uint16_t k) { return c.key < k; });
+    if (it == containers.end() || it->key != key) return false;
+    if (!it->bits.empty()) return testBit(it->bits, low);
+    return std::binary_search(it->values.begin(), it->values.end(), low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const Container &c : containers) total += c.cardinality;
+    return total;
+}
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap &other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < containers.size() && j < other.containers.size()) {
+        const Container &a = containers[i], &b = other.containers[j];
+        if (a.key < b.key) {
+            ++i;
+        } else if (b.key < a.key) {
+            ++j;
+        } else {
+            Container c = intersect(a, b);
+            if (c.cardinality) {
+                result.last = (uint32_t(c.key) << 16) | maxOf(c);
+                result.containers.push_back(std::move(c));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap &RoaringBitmap::operator&=(const RoaringBitmap &other) {
+    *this = *this & other;
+    return *this;
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container &a, const Container &b) {
+    Container c;
+    c.key = a.key;
+    if (!a.bits.empty() && !b.bits.empty()) {
+        c.bits.resize(BITMAP_WORDS);
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            c.bits[w] = a.bits[w] & b.bits[w];
+            c.cardinality += popCount64(c.bits[w]);
+        }
+        if (c.cardinality <= ARRAY_LIMIT) toArray(c);
+        return c;
+    }
+    if (!a.bits.empty() || !b.bits.empty()) {
+        const Container &array = a.bits.empty() ? a : b;
+        const Container &bitmap = a.bits.empty() ? b : a;
+        for (uint16_t v : array.values)
+            if (testBit(bitmap.bits, v)) c.values.push_back(v);
+        c.cardinality = (uint32_t)c.values.size();
+        return c;
+    }
+
+    const std::vector<uint16_t> &small = a.values.size() <= b.values.size() ? a.values : b.values;
+    const std::vector<uint16_t> &large = a.values.size() <= b.values.size() ? b.values : a.values;
+    c.values.reserve(small.size());
+    if (small.size() * GALLOP_RATIO < large.size()) {
+        auto from = large.begin();
+        for (uint16_t v : small) {
+            from = std::lower_bound(from, large.end(), v);
+            if (from == large.end()) break;
+            if (*from == v) c.values.push_back(v);
+        }
+    } else {
+        std::set_intersection(small.begin(), small.end(), large.begin(), large.end(), std::back_inserter(c.values));
+    }
+    c.cardinality = (uint32_t)c.values.size();
+    return c;
+}
+
+uint16_t RoaringBitmap::maxOf(const Container &c) {
+    if (c.bits.empty()) return c.values.back();
+    size_t w = c.bits.size();
+    while (!c.bits[--w]) {}
+    int bit = 0;
+    for (uint64_t word = c.bits[w]; word; word &= word - 1) bit = bitIndex64(word);
+    return uint16_t(w * 64 + bit);
+}
+
+void RoaringBitmap::toArray(Container &c) {
+    c.values.clear();
+    c.values.reserve(c.cardinality);
+    for (size_t w = 0; w < c.bits.size(); ++w) {
+        for (uint64_t word = c.bits[w]; word; word &= word - 1)
+            c.values.push_back(uint16_t(w * 64 + bitIndex64(word)));
+    }
+    std::vector<uint64_t>().swap(c.bits);
+}
+
+std::vector<uint32_t> RoaringBitmap::values() const {
+    std::vector<uint32_t> out;
+    out.reserve(cardinality());
+    forEach([&](uint32_t v) {
+        out.push_back(v);
+        return true;
+    });
+    return out;
+}
+
+size_t RoaringBitmap::bytes() const {
+    size_t total = containers.capacity() * sizeof(Container);
+    for (const Container &c : containers)
+        total += c.values.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    return total;
+}
+
+} // namespace Core
+} // namespace NQueens
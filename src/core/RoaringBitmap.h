@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bitops.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// Roaring 风格的压缩位图：32 位值按高 16 位分桶，每桶一个容器。
+		// 不超过 4096 个值的桶存为有序的 16 位数组，更多时改为 65536 位的位图，两种形式各自不超过 8 KB。
+		// 求交按桶合并：数组与数组逐个查找（悬殊时二分），数组与位图逐个测试，位图与位图按字求与。
+		class RoaringBitmap {
+		public:
+			static const uint32_t ARRAY_LIMIT = 4096;
+
+			// 追加的值必须严格递增，否则抛出 std::invalid_argument
+			void append(uint32_t value);
+
+			// [0, count) 的全部值
+			static RoaringBitmap range(uint32_t count);
+
+			bool contains(uint32_t value) const;
+			uint64_t cardinality() const;
+			bool empty() const { return containers.empty(); }
+
+			RoaringBitmap operator&(const RoaringBitmap &other) const;
+			RoaringBitmap &operator&=(const RoaringBitmap &other);
+
+			// 按从小到大的顺序回调每个值，回调返回 false 时停止
+			template <typename F>
+			void forEach(F &&visit) const {
+				for (const Container &c : containers) {
+					uint32_t high = uint32_t(c.key) << 16;
+					if (c.bits.empty()) {
+						for (uint16_t low : c.values)
+							if (!visit(high | low)) return;
+						continue;
+					}
+					for (size_t w = 0; w < c.bits.size(); ++w) {
+						for (uint64_t word = c.bits[w]; word; word &= word - 1)
+							if (!visit(high | uint32_t(w * 64 + bitIndex64(word)))) return;
+					}
+				}
+			}
+
+			std::vector<uint32_t> values() const;
+
+			size_t containerCount() const { return containers.size(); }
+			size_t bytes() const;
+
+		private:
+			struct Container {
+				uint16_t key = 0;
+				uint32_t cardinality = 0;
+				std::vector<uint16_t> values;  // 数组形式
+				std::vector<uint64_t> bits;    // 位图形式，非空时 values 不用
+			};
+
+			static Container intersect(const Container &a, const Container &b);
+			static uint16_t maxOf(const Container &c);
+			static void toArray(Container &c);
+
+			std::vector<Container> containers;
+			uint32_t last = 0;  // 最大值，containers 为空时无意义
+		};
+
+	} // namespace Core
+} // namespace NQueens
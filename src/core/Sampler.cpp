@@ -0,0 +1,98 @@
+#include "Sampler.h"
+#include "Bitops.h"
+#include "TreeEstimator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 近似模式中连续走入死路的上限，超过说明该 N 无解或探测次数太少
+const uint64_t MAX_RESTARTS = 1 << 20;
+
+WorkUnit child(const WorkUnit &parent, uint32_t bit) {
+    WorkUnit next;
+    next.prefix = parent.prefix;
+    next.prefix.push_back(bitIndex(bit));
+    next.cols = parent.cols | bit;
+    next.ld = (parent.ld | bit) << 1;
+    next.rd = (parent.rd | bit) >> 1;
+    return next;
+}
+
+} // namespace
+
+Sampler::Sampler(int n, SamplerOptions options, ResultCache *cache)
+    : n(n), options(options), counter(n) {
+    this->options.probes = std::max(1, this->options.probes);
+    this->options.exactRows = std::max(0, this->options.exactRows);
+    uint64_t seed = options.seed ? options.seed : ((uint64_t)std::random_device{}() << 32 ^ std::random_device{}());
+    rng.seed(seed);
+
+    if (!options.approximate) {
+        index.reset(new SolutionIndex(n, cache));
+        index->warmUp(options.warmDepth < 0 ? std::max(1, n / 4) : options.warmDepth, options.threads);
+        solutions = index->total();
+        if (solutions == 0) throw std::runtime_error("N=" + std::to_string(n) + " 无解，无法采样");
+    } else if (n == 2 || n == 3) {
+        throw std::runtime_error("N=" + std::to_string(n) + " 无解，无法采样");
+    }
+}
+
+Sampler::~Sampler() = default;
+
+std::vector<int> Sampler::next() {
+    if (options.approximate) return descendApproximate();
+    // 按子树解数成比例地逐行选择分支，与对均匀序号做 unrank 完全相同
+    uint64_t k = std::uniform_int_distribution<uint64_t>(0, solutions - 1)(rng);
+    return index->unrank(k);
+}
+
+std::vector<int> Sampler::descendApproximate() {
+    const uint32_t full = fullMask(n);
+    uint64_t attempts = 0;
+    for (;;) {
+        WorkUnit node;
+        bool deadEnd = false;
+        for (int row = 0; row < n; ++row) {
+            uint32_t avail = full & ~(node.cols | node.ld | node.rd);
+            std::vector<WorkUnit> children;
+            std::vector<double> weights;
+            double sum = 0;
+            // 子前缀下方剩余的行数不多时精确计数，否则随机探测估计
+            bool exactRow = n - 1 - row <= options.exactRows;
+            for (; avail; avail &= avail - 1) {
+                WorkUnit next = child(node, lowestBit(avail));
+                double w;
+                if (exactRow) {
+                    w = (double)counter.countUnit(next).solutions;
+                } else {
+                    // 每个分支用独立的种子，避免兄弟分支沿同一批随机路径探测而产生相关偏差
+                    w = TreeEstimator(n, rng()).estimateUnit(next, options.probes).solutions;
+                }
+                if (w <= 0) continue;
+                sum += w;
+                weights.push_back(w);
+                children.push_back(std::move(next));
+            }
+            if (children.empty()) {
+                deadEnd = true;
+                break;
+            }
+            double pick = std::uniform_real_distribution<double>(0, sum)(rng);
+            size_t i = 0;
+            while (i + 1 < children.size() && pick >= weights[i]) pick -= weights[i++];
+            node = std::move(children[i]);
+        }
+        if (!deadEnd) return node.prefix;
+        deadEnds++;
+        if (++attempts >= MAX_RESTARTS)
+            throw std::runtime_error("近似采样反复走入死路，请增加 --probes");
+    }
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "NQueensCounter.h"
+#include "ResultCache.h"
+#include "SolutionIndex.h"
+
+namespace NQueens {
+	namespace Core {
+
+		struct SamplerOptions {
+			bool approximate = false;  // 近似模式：不需要整棵树的计数，适合精确计数代价过高的 N
+			uint64_t seed = 0;         // 0 表示取随机种子
+			int threads = 1;           // 精确模式预热时的线程数
+			int warmDepth = -1;        // 精确模式预热深度，负数表示 max(1, N/4)
+			int probes = 16;           // 近似模式下估计每个子前缀完成数的随机探测次数
+			int exactRows = 8;         // 近似模式下剩余行数不超过该值时改用精确子树计数
+		};
+
+		// 随机解采样器。精确模式沿位运算搜索树下降，按各子前缀的子树解数成比例地选择分支，
+		// 得到严格均匀的分布（等价于对均匀随机序号做 unrank），子树解数只算一次并可经 cache 跨进程复用。
+		// 近似模式在靠上的行用 Knuth 随机探测估计各分支的完成数，最后 exactRows 行改为精确计数；
+		// 估计为零的分支不会被选中，走入死路时从头重来。N <= exactRows 时两种模式同样均匀。非线程安全。
+		class Sampler {
+		public:
+			explicit Sampler(int n, SamplerOptions options = {}, ResultCache *cache = nullptr);
+			~Sampler();
+
+			int size() const { return n; }
+			bool exact() const { return !options.approximate; }
+
+			// 取下一个随机解；N 无解时抛出 std::runtime_error
+			std::vector<int> next();
+
+			// 精确模式下的总解数；近似模式返回 0
+			uint64_t total() const { return solutions; }
+
+			// 近似模式中走入死路后重来的次数
+			uint64_t restarts() const { return deadEnds; }
+
+		private:
+			std::vector<int> descendApproximate();
+
+			int n;
+			SamplerOptions options;
+			std::mt19937_64 rng;
+			std::unique_ptr<SolutionIndex> index;
+			NQueensCounter counter;
+			uint64_t solutions = 0;
+			uint64_t deadEnds = 0;
+		};
+
+	} // namespace Core
+} // namespace NQueens
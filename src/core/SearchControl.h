@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace NQueens {
+	namespace Core {
+
+		class ResultCache;
+		class WorkerMonitor;
+
+		// 协作式取消令牌：拷贝共享同一个标志，热循环中只做一次 relaxed 读取
+		class CancellationToken {
+		public:
+			CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+			void cancel() { flag->store(true, std::memory_order_relaxed); }
+			bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+
+		private:
+			std::shared_ptr<std::atomic<bool>> flag;
+		};
+
+		// 运行预算，0 表示不限制
+		struct SearchBudget {
+			std::chrono::milliseconds timeLimit{0};
+			uint64_t maxNodes = 0;
+		};
+
+		enum class RunStatus { Completed, Cancelled, TimedOut, NodeLimit };
+
+		const char *runStatusName(RunStatus status);
+
+		struct SearchProgress {
+			uint64_t nodes = 0;
+			uint64_t solutions = 0;      // 已完成工作单元的解数（含对称权重）
+			double fraction = 0;         // 按估计节点数计算的完成比例
+			double elapsedSeconds = 0;
+			double etaSeconds = -1;      // 尚无法估计时为负数
+		};
+
+		using ProgressCallback = std::function<void(const SearchProgress &)>;
+
+		struct SearchOptions {
+			int threads = 1;
+			ResultCache *cache = nullptr;
+			CancellationToken token;
+			SearchBudget budget;
+			ProgressCallback onProgress;  // 在执行搜索的线程上按 progressInterval 节流调用
+			std::chrono::milliseconds progressInterval{200};
+			WorkerMonitor *workers = nullptr;  // 非空时各工作线程周期性发布当前部分棋盘与计数
+		};
+
+		// status 不为 Completed 时 partial 为真，solutions/nodes 只包含已完整搜索的工作单元
+		struct SearchResult {
+			RunStatus status = RunStatus::Completed;
+			bool partial = false;
+			uint64_t solutions = 0;
+			uint64_t nodes = 0;
+			double fraction = 0;
+			size_t unitsDone = 0;
+			size_t unitsTotal = 0;
+			double elapsedSeconds = 0;
+		};
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace NQueens {
+	namespace Core {
+
+		// 单写者顺序锁：写者从不等待，读者读到写入中途的数据时重试。
+		// 整个槽按缓存行对齐，相邻线程的槽不会伪共享。数据按 64 位字逐个原子读写，没有数据竞争。
+		template <class T>
+		class alignas(64) Seqlock {
+			static_assert(std::is_trivially_copyable<T>::value, "Seqlock 只能保存可平凡拷贝的类型");
+
+		public:
+			// 只能由唯一的写者线程调用
+			void store(const T &value) {
+				uint64_t buffer[WORDS] = {};
+				std::memcpy(buffer, &value, sizeof(T));
+				uint32_t s = seq.load(std::memory_order_relaxed);
+				seq.store(s + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				for (size_t i = 0; i < WORDS; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+				seq.store(s + 2, std::memory_order_release);
+			}
+
+			// 读到一致的快照时返回 true
+			bool tryLoad(T &out) const {
+				uint32_t before = seq.load(std::memory_order_acquire);
+				if (before & 1) return false;
+				uint64_t buffer[WORDS];
+				for (size_t i = 0; i < WORDS; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (seq.load(std::memory_order_relaxed) != before) return false;
+				std::memcpy(&out, buffer, sizeof(T));
+				return true;
+			}
+
+			// 最多重试 attempts 次，写者极其频繁时可能失败
+			bool load(T &out, int attempts = 64) const {
+				for (int i = 0; i < attempts; ++i) {
+					if (tryLoad(out)) return true;
+					if (i >= 8) std::this_thread::yield();
+				}
+				return false;
+			}
+
+			// 版本号，每完成一次写入加 2
+			uint32_t version() const { return seq.load(std::memory_order_acquire); }
+
+		private:
+			static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+			std::atomic<uint32_t> seq{0};
+			std::atomic<uint64_t> words[WORDS] = {};
+		};
+
+	} // namespace Core
+} // namespace NQueens
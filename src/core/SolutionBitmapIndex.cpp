@@ -0,0 +1,52 @@
+#include "SolutionBitmapIndex.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+SolutionBitmapIndex::SolutionBitmapIndex(const PackedSolutions &solutions)
+    : n(solutions.boardSize()), total(0), cells((size_t)n * n) {
+    if (solutions.size() > UINT32_MAX)
+        throw std::length_error("解数超过位图索引的上限: " + std::to_string(solutions.size()));
+    total = (uint32_t)solutions.size();
+
+    // 编号递增地逐个解码，每个解恰好向每行的一个位图追加一次
+    int queens[MAX_BOARD_SIZE];
+    for (uint32_t id = 0; id < total; ++id) {
+        solutions.unpack(id, queens);
+        for (int r = 0; r < n; ++r) cells[(size_t)r * n + queens[r]].append(id);
+    }
+}
+
+RoaringBitmap SolutionBitmapIndex::query(const std::vector<int> &fixedColumns) const {
+    if (!fixedColumns.empty() && (int)fixedColumns.size() != n)
+        throw std::invalid_argument("固定列的行数与棋盘大小不符");
+    std::vector<const RoaringBitmap *> operands;
+    for (int r = 0; r < (int)fixedColumns.size(); ++r) {
+        int c = fixedColumns[r];
+        if (c < 0) continue;
+        if (c >= n) throw std::invalid_argument("第 " + std::to_string(r) + " 行的固定列超出棋盘: " + std::to_string(c));
+        operands.push_back(&cell(r, c));
+    }
+    if (operands.empty()) return RoaringBitmap::range(total);
+
+    // 先交基数最小的两个，中间结果只会更小，空集时提前结束
+    std::sort(operands.begin(), operands.end(), [](const RoaringBitmap *a, const RoaringBitmap *b) {
+        return a->cardinality() < b->cardinality();
+    });
+    if (operands.size() == 1) return *operands[0];
+    RoaringBitmap result = *operands[0] & *operands[1];
+    for (size_t i = 2; i < operands.size() && !result.empty(); ++i) result &= *operands[i];
+    return result;
+}
+
+size_t SolutionBitmapIndex::bytes() const {
+    size_t sum = cells.capacity() * sizeof(RoaringBitmap);
+    for (const RoaringBitmap &b : cells) sum += b.bytes();
+    return sum;
+}
+
+} // namespace Core
+} // namespace NQueens
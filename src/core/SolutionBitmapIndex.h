@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PackedSolutions.h"
+#include "RoaringBitmap.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 解集合上的逐格位图索引：解按在 PackedSolutions 中的位置编号，每个格子 (r, c) 一个压缩位图，
+		// 记录第 r 行皇后在第 c 列的全部解。同一行的 n 个位图互不相交且并起来是全集，所以总元素数为 解数×N。
+		// 多格查询按基数从小到大依次求交，结果仍是位图，可直接按编号从 PackedSolutions 取解。构建后只读，可跨线程共享。
+		class SolutionBitmapIndex {
+		public:
+			// 解数超过 2^32 时抛出 std::length_error
+			explicit SolutionBitmapIndex(const PackedSolutions &solutions);
+
+			int boardSize() const { return n; }
+			uint32_t size() const { return total; }
+
+			const RoaringBitmap &cell(int row, int col) const { return cells[(size_t)row * n + col]; }
+
+			// fixedColumns[r] >= 0 表示第 r 行的皇后必须在该列，-1 表示自由；为空或全部自由时返回全集。
+			// 超出棋盘的格子抛出 std::invalid_argument
+			RoaringBitmap query(const std::vector<int> &fixedColumns) const;
+
+			size_t bytes() const;
+
+		private:
+			int n;
+			uint32_t total;
+			std::vector<RoaringBitmap> cells;
+		};
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,394 @@
+#include "SolutionDag.h"
+#include "Bitops.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 出边字的布局：低 5 位列号，第 5 位表示节点的最后一条出边，高 26 位为目标节点
+const uint32_t COL_MASK = 0x1F;
+const uint32_t LAST_EDGE = 1u << 5;
+const int TARGET_SHIFT = 6;
+const uint32_t MAX_WORDS = 1u << (32 - TARGET_SHIFT);
+
+// 下标 0 保留给第 n 行的终点，不是任何节点的出边
+const uint32_t TERMINAL = 0;
+const uint32_t NONE = 0xFFFFFFFFu;
+
+const uint64_t HASH_SEED = 0xCBF29CE484222325ull;
+
+uint64_t mixEdge(uint64_t h, uint32_t col, uint32_t target) {
+    h ^= ((uint64_t)target << 5) | col;
+    h *= 0x100000001B3ull;
+    return h ^ (h >> 29);
+}
+
+// 表示 0..maxValue 所需的位数，至少 1 位
+int bitsFor(uint64_t maxValue) {
+    int bits = 1;
+    while (bits < 64 && (maxValue >> bits) != 0) ++bits;
+    return bits;
+}
+
+const size_t RANK_BLOCK_WORDS = 8;
+
+uint32_t colOf(uint32_t word) { return word & COL_MASK; }
+uint32_t targetOf(uint32_t word) { return word >> TARGET_SHIFT; }
+bool isLast(uint32_t word) { return (word & LAST_EDGE) != 0; }
+
+} // namespace
+
+SolutionDag::SolutionDag(int n) : n(n), full(fullMask(n)) {
+    if (n < 0 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+    if (n == 0) return;
+
+    words.push_back(0);
+    table.assign(1024, NONE);
+    scratch.resize(n);
+
+    // 第 0 行右半的子树是左半子树的镜像，只需在已合并的图上翻转，不必再搜索
+    std::vector<uint32_t> left(n, NONE);
+    for (int c = 0; c < (n + 1) / 2; ++c) {
+        uint32_t bit = 1u << c;
+        left[c] = build(1, bit, bit << 1, bit >> 1);
+    }
+    std::vector<uint32_t> memo(words.size(), NONE);
+    std::vector<Edge> out;
+    for (int c = 0; c < n; ++c) {
+        uint32_t child = c < (n + 1) / 2 ? left[c] : NONE;
+        if (c >= (n + 1) / 2 && left[n - 1 - c] != NONE) child = mirrorOf(left[n - 1 - c], memo);
+        if (child != NONE) out.push_back({(uint32_t)c, child});
+    }
+    uint32_t root = out.empty() ? NONE : intern(out);
+
+    std::vector<uint32_t>().swap(memo);
+    std::vector<uint32_t>().swap(table);
+    std::vector<std::vector<Edge>>().swap(scratch);
+    if (root != NONE) {
+        total = builtCount(root);
+        compress(root);
+    }
+    std::vector<uint32_t>().swap(words);
+}
+
+uint32_t SolutionDag::build(int row, uint32_t cols, uint32_t ld, uint32_t rd) {
+    if (row == n) return TERMINAL;
+    std::vector<Edge> &out = scratch[row];
+    out.clear();
+    uint32_t avail = full & ~(cols | ld | rd);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        uint32_t child = build(row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1);
+        if (child != NONE) out.push_back({(uint32_t)bitIndex(bit), child});
+    }
+    return out.empty() ? NONE : intern(out);
+}
+
+uint32_t SolutionDag::mirrorOf(uint32_t node, std::vector<uint32_t> &memo) {
+    if (node == TERMINAL) return TERMINAL;
+    if (memo[node] != NONE) return memo[node];
+    std::vector<Edge> out;
+    for (uint32_t e = node;; ++e) {
+        out.push_back({(uint32_t)(n - 1) - colOf(words[e]), targetOf(words[e])});
+        if (isLast(words[e])) break;
+    }
+    // 镜像后列号反序，目标同样换成镜像节点
+    std::vector<Edge> mirrored(out.rbegin(), out.rend());
+    for (Edge &edge : mirrored) edge.target = mirrorOf(edge.target, memo);
+    return memo[node] = intern(mirrored);
+}
+
+uint64_t SolutionDag::hashNode(uint32_t node) const {
+    uint64_t h = HASH_SEED;
+    for (uint32_t e = node;; ++e) {
+        h = mixEdge(h, colOf(words[e]), targetOf(words[e]));
+        if (isLast(words[e])) return h;
+    }
+}
+
+bool SolutionDag::sameEdges(uint32_t node, const std::vector<Edge> &out) const {
+    for (size_t i = 0; i < out.size(); ++i) {
+        uint32_t word = words[node + i];
+        if (colOf(word) != out[i].col || targetOf(word) != out[i].target) return false;
+        if (isLast(word) != (i + 1 == out.size())) return false;
+    }
+    return true;
+}
+
+void SolutionDag::growTable() {
+    std::vector<uint32_t> old;
+    old.swap(table);
+    table.assign(old.size() * 2, NONE);
+    const size_t mask = table.size() - 1;
+    for (uint32_t node : old) {
+        if (node == NONE) continue;
+        size_t slot = hashNode(node) & mask;
+        while (table[slot] != NONE) slot = (slot + 1) & mask;
+        table[slot] = node;
+    }
+}
+
+uint32_t SolutionDag::intern(const std::vector<Edge> &out) {
+    // 出边完全相同的节点代表同一个完成集合，直接复用
+    uint64_t h = HASH_SEED;
+    for (const Edge &edge : out) h = mixEdge(h, edge.col, edge.target);
+    const size_t mask = table.size() - 1;
+    size_t slot = h & mask;
+    for (; table[slot] != NONE; slot = (slot + 1) & mask)
+        if (sameEdges(table[slot], out)) return table[slot];
+
+    if (words.size() + out.size() + 1 > MAX_WORDS)
+        throw std::length_error("解集合过大，超出压缩表示的容量（N=" + std::to_string(n) + "）");
+
+    uint32_t node = (uint32_t)words.size();
+    uint64_t completions = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        words.push_back(out[i].col | (i + 1 == out.size() ? LAST_EDGE : 0) | out[i].target << TARGET_SHIFT);
+        completions += builtCount(out[i].target);
+    }
+    if (out.size() > 1) {
+        if (completions > 0xFFFFFFFFu)
+            throw std::length_error("解集合过大，超出压缩表示的容量（N=" + std::to_string(n) + "）");
+        words.push_back((uint32_t)completions);
+    }
+    nodes++;
+    edges += out.size();
+
+    table[slot] = node;
+    if (nodes * 2 > table.size()) growTable();
+    return node;
+}
+
+uint64_t SolutionDag::builtCount(uint32_t node) const {
+    // 单出边节点的完成数等于其唯一子节点的完成数
+    while (node != TERMINAL && isLast(words[node])) node = targetOf(words[node]);
+    if (node == TERMINAL) return 1;
+    uint32_t e = node;
+    while (!isLast(words[e])) ++e;
+    return words[e + 1];
+}
+
+void SolutionDag::PackedInts::reset(int width, size_t length) {
+    this->width = width;
+    words.assign((length * (size_t)width + 63) / 64, 0);
+}
+
+void SolutionDag::PackedInts::set(size_t index, uint64_t value) {
+    size_t bit = index * (size_t)width;
+    size_t word = bit / 64, offset = bit % 64;
+    words[word] |= value << offset;
+    if (offset + width > 64) words[word + 1] |= value >> (64 - offset);
+}
+
+uint64_t SolutionDag::PackedInts::get(size_t index) const {
+    size_t bit = index * (size_t)width;
+    size_t word = bit / 64, offset = bit % 64;
+    uint64_t value = words[word] >> offset;
+    if (offset + width > 64) value |= words[word + 1] << (64 - offset);
+    return width == 64 ? value : value & ((1ull << width) - 1);
+}
+
+void SolutionDag::RankedBits::reset(size_t length) {
+    bits.assign((length + 63) / 64, 0);
+    blockRank.clear();
+}
+
+void SolutionDag::RankedBits::buildIndex() {
+    blockRank.assign(bits.size() / RANK_BLOCK_WORDS + 1, 0);
+    uint32_t ones = 0;
+    for (size_t w = 0; w < bits.size(); ++w) {
+        if (w % RANK_BLOCK_WORDS == 0) blockRank[w / RANK_BLOCK_WORDS] = ones;
+        ones += (uint32_t)popCount64(bits[w]);
+    }
+    if (bits.size() % RANK_BLOCK_WORDS == 0) blockRank.back() = ones;
+}
+
+size_t SolutionDag::RankedBits::rank(size_t index) const {
+    size_t word = index / 64;
+    size_t ones = blockRank[word / RANK_BLOCK_WORDS];
+    for (size_t w = word / RANK_BLOCK_WORDS * RANK_BLOCK_WORDS; w < word; ++w) ones += popCount64(bits[w]);
+    if (index % 64) ones += popCount64(bits[word] & ((1ull << (index % 64)) - 1));
+    return ones;
+}
+
+size_t SolutionDag::RankedBits::select(size_t k) const {
+    // 最后一个累计数不超过 k 的块，第 k 个 1 就在其中
+    size_t block = std::upper_bound(blockRank.begin(), blockRank.end(), (uint32_t)k) - blockRank.begin() - 1;
+    size_t left = k - blockRank[block];
+    for (size_t w = block * RANK_BLOCK_WORDS;; ++w) {
+        uint64_t word = bits[w];
+        size_t ones = popCount64(word);
+        if (left < ones) {
+            while (left--) word &= word - 1;
+            return w * 64 + bitIndex64(word);
+        }
+        left -= ones;
+    }
+}
+
+void SolutionDag::compress(uint32_t root) {
+    // 逐行编号：本行节点按上一行出边首次引用的顺序排列，renumber 记录构建期下标到行内编号的映射
+    std::vector<uint32_t> renumber(words.size(), NONE);
+    std::vector<uint32_t> current{root}, next;
+    levels.resize(n);
+    for (int row = 0; row < n; ++row) {
+        Level &level = levels[row];
+        const bool lastRow = row + 1 == n;
+        std::vector<uint32_t> cols, links;
+        std::vector<uint64_t> counts;
+        std::vector<size_t> lastEdges, freshEdges;
+        next.clear();
+        uint64_t maxCount = 0;
+        for (uint32_t node : current) {
+            counts.push_back(builtCount(node));
+            maxCount = std::max(maxCount, counts.back());
+            for (uint32_t e = node;; ++e) {
+                uint32_t word = words[e];
+                size_t index = cols.size();
+                cols.push_back(colOf(word));
+                if (!lastRow) {
+                    uint32_t target = targetOf(word);
+                    if (renumber[target] == NONE) {
+                        renumber[target] = (uint32_t)next.size();
+                        next.push_back(target);
+                        freshEdges.push_back(index);
+                    } else {
+                        links.push_back(renumber[target]);
+                    }
+                }
+                if (isLast(word)) {
+                    lastEdges.push_back(index);
+                    break;
+                }
+            }
+        }
+
+        level.nodeCount = (uint32_t)current.size();
+        level.edgeCount = (uint32_t)cols.size();
+        level.cols.reset(bitsFor((uint64_t)n - 1), cols.size());
+        for (size_t i = 0; i < cols.size(); ++i) level.cols.set(i, cols[i]);
+        level.last.reset(cols.size());
+        for (size_t i : lastEdges) level.last.set(i);
+        level.last.buildIndex();
+        if (!lastRow) {
+            level.fresh.reset(cols.size());
+            for (size_t i : freshEdges) level.fresh.set(i);
+            level.fresh.buildIndex();
+            level.links.reset(bitsFor(next.size() - 1), links.size());
+            for (size_t i = 0; i < links.size(); ++i) level.links.set(i, links[i]);
+        }
+        level.counts.reset(bitsFor(maxCount), counts.size());
+        for (size_t i = 0; i < counts.size(); ++i) level.counts.set(i, counts[i]);
+
+        current.swap(next);
+    }
+}
+
+size_t SolutionDag::bytes() const {
+    size_t words64 = 0, words32 = 0;
+    for (const Level &level : levels) {
+        words64 += level.cols.words.capacity() + level.links.words.capacity() + level.counts.words.capacity() +
+                   level.last.bits.capacity() + level.fresh.bits.capacity();
+        words32 += level.last.blockRank.capacity() + level.fresh.blockRank.capacity();
+    }
+    return words64 * sizeof(uint64_t) + words32 * sizeof(uint32_t) + levels.capacity() * sizeof(Level);
+}
+
+uint32_t SolutionDag::firstEdge(int row, uint32_t node) const {
+    return node == 0 ? 0 : (uint32_t)levels[row].last.select(node - 1) + 1;
+}
+
+uint32_t SolutionDag::edgeTarget(int row, uint32_t edge) const {
+    const Level &level = levels[row];
+    if (row + 1 == n) return 0;
+    size_t fresh = level.fresh.rank(edge);
+    return level.fresh.get(edge) ? (uint32_t)fresh : (uint32_t)level.links.get(edge - fresh);
+}
+
+uint64_t SolutionDag::countOf(int row, uint32_t node) const {
+    return row == n ? 1 : levels[row].counts.get(node);
+}
+
+void SolutionDag::visit(int row, uint32_t node, std::vector<int> &path, const SolutionSink &sink) const {
+    if (row == n) {
+        sink(path);
+        return;
+    }
+    const Level &level = levels[row];
+    for (uint32_t e = firstEdge(row, node);; ++e) {
+        path[row] = (int)level.cols.get(e);
+        visit(row + 1, edgeTarget(row, e), path, sink);
+        if (level.last.get(e)) break;
+    }
+}
+
+void SolutionDag::forEach(const SolutionSink &sink) const {
+    if (levels.empty()) return;
+    std::vector<int> path(n);
+    visit(0, 0, path, sink);
+}
+
+std::vector<int> SolutionDag::at(uint64_t index) const {
+    if (index >= total)
+        throw std::out_of_range("解序号越界: " + std::to_string(index) + "（共 " + std::to_string(total) + " 个解）");
+    std::vector<int> queens;
+    uint32_t node = 0;
+    for (int row = 0; row < n; ++row) {
+        uint32_t e = firstEdge(row, node);
+        for (uint64_t size; index >= (size = countOf(row + 1, edgeTarget(row, e))); ++e) index -= size;
+        queens.push_back((int)levels[row].cols.get(e));
+        node = edgeTarget(row, e);
+    }
+    return queens;
+}
+
+bool SolutionDag::contains(const std::vector<int> &queens) const {
+    if (levels.empty() || (int)queens.size() != n) return false;
+    uint32_t node = 0;
+    for (int row = 0; row < n; ++row) {
+        const Level &level = levels[row];
+        uint32_t e = firstEdge(row, node);
+        while (level.cols.get(e) < (uint64_t)queens[row] && !level.last.get(e)) ++e;
+        if (level.cols.get(e) != (uint64_t)queens[row]) return false;
+        node = edgeTarget(row, e);
+    }
+    return true;
+}
+
+uint64_t SolutionDag::count(const std::vector<int> &fixedColumns) const {
+    if (fixedColumns.empty()) return total;
+    if ((int)fixedColumns.size() != n) throw std::invalid_argument("约束的行数与棋盘大小不符");
+    if (levels.empty()) return 0;
+    int lastFixed = -1;
+    for (int r = 0; r < n; ++r)
+        if (fixedColumns[r] >= 0) lastFixed = r;
+
+    // 只需记忆最后一个固定行及以上的节点；再往下不受约束，直接取完成数
+    std::unordered_map<uint64_t, uint64_t> memo;
+    auto countFrom = [&](auto &self, uint32_t node, int row) -> uint64_t {
+        if (row > lastFixed) return countOf(row, node);
+        uint64_t key = (uint64_t)row << 32 | node;
+        auto it = memo.find(key);
+        if (it != memo.end()) return it->second;
+        const Level &level = levels[row];
+        uint64_t sum = 0;
+        for (uint32_t e = firstEdge(row, node);; ++e) {
+            if (fixedColumns[row] < 0 || (uint64_t)fixedColumns[row] == level.cols.get(e))
+                sum += self(self, edgeTarget(row, e), row + 1);
+            if (level.last.get(e)) break;
+        }
+        memo[key] = sum;
+        return sum;
+    };
+    return countFrom(countFrom, 0, 0);
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "NQueensCounter.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 全部解的压缩表示：按行把解组织成前缀树，再把完成集合相同的子树合并成同一个节点，得到最小的有向无环图。
+		// 构建时先在 32 位字数组上做哈希合并，完成后按行重排成紧凑的位级表示：每行的节点按被上一行首次引用的顺序编号，
+		// 每条出边只存列号（ceil(log2 n) 位）、末条标记与“目标是下一行的下一个新节点”标记各 1 位，
+		// 只有指向已出现节点的边另存目标编号，位宽按下一行的节点数取；每个节点的完成数按本行最大值定宽存放。
+		// 上层各行几乎是一棵树，目标多为新节点，合并主要发生在下层，因此总体小于 PackedSolutions 的逐解定宽存储
+		// （N=14 约 1.74 MB，PackedSolutions 约 2.44 MB）。
+		// 由位运算搜索直接构建，不经过逐个解的中间集合。
+		class SolutionDag {
+		public:
+			explicit SolutionDag(int n = 0);
+
+			int boardSize() const { return n; }
+			uint64_t size() const { return total; }
+			bool empty() const { return total == 0; }
+
+			// 按字典序（逐行比较列号）依次回调每个解
+			void forEach(const SolutionSink &sink) const;
+
+			// 字典序中的第 index 个解，越界时抛出 std::out_of_range
+			std::vector<int> at(uint64_t index) const;
+
+			bool contains(const std::vector<int> &queens) const;
+
+			// fixedColumns[r] >= 0 表示第 r 行的皇后必须在该列，-1 表示自由；为空时即 size()
+			uint64_t count(const std::vector<int> &fixedColumns) const;
+
+			size_t nodeCount() const { return nodes; }
+			size_t edgeCount() const { return edges; }
+			size_t bytes() const;
+
+		private:
+			struct Edge {
+				uint32_t col;
+				uint32_t target;
+			};
+
+			// 定宽整数数组，各值按位首尾相接存入 64 位字
+			struct PackedInts {
+				int width = 1;
+				std::vector<uint64_t> words;
+
+				void reset(int width, size_t length);
+				void set(size_t index, uint64_t value);  // 只能写入尚未写过的位置
+				uint64_t get(size_t index) const;
+			};
+
+			// 位向量，每 512 位记一次此前 1 的个数，rank 为常数时间，select 在块上二分
+			struct RankedBits {
+				std::vector<uint64_t> bits;
+				std::vector<uint32_t> blockRank;
+
+				void reset(size_t length);
+				void set(size_t index) { bits[index / 64] |= 1ull << (index % 64); }
+				bool get(size_t index) const { return (bits[index / 64] >> (index % 64)) & 1; }
+				void buildIndex();
+				size_t rank(size_t index) const;    // [0, index) 中 1 的个数
+				size_t select(size_t k) const;      // 第 k 个 1（从 0 计）的位置
+			};
+
+			// 一行的节点与出边；节点的出边连续存放，按列号递增
+			struct Level {
+				uint32_t nodeCount = 0;
+				uint32_t edgeCount = 0;
+				PackedInts cols;     // 每条边的列号
+				RankedBits last;     // 节点的最后一条出边
+				RankedBits fresh;    // 目标是下一行尚未出现的节点，编号即此前的 fresh 边数；最后一行为空
+				PackedInts links;    // 其余边的目标编号，按非 fresh 边的顺序
+				PackedInts counts;   // 每个节点的完成数
+			};
+
+			// 构建期：在 words 上做哈希合并
+			uint32_t build(int row, uint32_t cols, uint32_t ld, uint32_t rd);
+			uint32_t mirrorOf(uint32_t node, std::vector<uint32_t> &memo);
+			uint32_t intern(const std::vector<Edge> &out);
+			bool sameEdges(uint32_t node, const std::vector<Edge> &out) const;
+			uint64_t hashNode(uint32_t node) const;
+			void growTable();
+			uint64_t builtCount(uint32_t node) const;
+			// 把 words 上的图按行重排成 levels，之后释放构建期的数据
+			void compress(uint32_t root);
+
+			uint32_t firstEdge(int row, uint32_t node) const;
+			uint32_t edgeTarget(int row, uint32_t edge) const;
+			uint64_t countOf(int row, uint32_t node) const;
+			void visit(int row, uint32_t node, std::vector<int> &path, const SolutionSink &sink) const;
+
+			int n;
+			uint32_t full;
+			uint64_t total = 0;
+			size_t nodes = 0;
+			size_t edges = 0;
+			std::vector<Level> levels;   // 为空表示没有解；第 0 行只有根节点 0
+
+			// 仅构建期间使用：图的 32 位字数组、按出边去重的开放寻址表与每行的临时出边
+			std::vector<uint32_t> words;
+			std::vector<uint32_t> table;
+			std::vector<std::vector<Edge>> scratch;
+		};
+
+	} // namespace Core
+} // namespace NQueens
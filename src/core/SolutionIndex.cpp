@@ -0,0 +1,161 @@
+#include "SolutionIndex.h"
+#include "Bitops.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 缓存中保存前缀小计的最大深度，与 NQueensCounter 写入的前缀一致
+const size_t CACHED_PREFIX_DEPTH = 2;
+
+// 子树小于该节点数时不记住结果：重算只需几微秒，大量随机查询时也不会让表无限增长
+const uint64_t MEMO_MIN_NODES = 256;
+
+WorkUnit child(const WorkUnit &parent, uint32_t bit) {
+    WorkUnit next;
+    next.prefix = parent.prefix;
+    next.prefix.push_back(bitIndex(bit));
+    next.cols = parent.cols | bit;
+    next.ld = (parent.ld | bit) << 1;
+    next.rd = (parent.rd | bit) >> 1;
+    return next;
+}
+
+} // namespace
+
+SolutionIndex::SolutionIndex(int n, ResultCache *cache)
+    : n(n), full(fullMask(n)), counter(n), cache(cache) {}
+
+std::vector<int> SolutionIndex::canonical(const std::vector<int> &prefix) const {
+    // 前缀与其左右镜像的子树解数相同，取字典序较小者作为键
+    std::vector<int> mirror(prefix);
+    for (int &c : mirror) c = (n - 1) - c;
+    return std::min(prefix, mirror);
+}
+
+void SolutionIndex::remember(const std::vector<int> &prefix, uint64_t count) {
+    counts[canonical(prefix)] = count;
+}
+
+uint64_t SolutionIndex::subtreeCount(const WorkUnit &unit) {
+    std::vector<int> key = canonical(unit.prefix);
+    auto it = counts.find(key);
+    if (it != counts.end()) return it->second;
+
+    CacheEntry entry;
+    bool persistent = cache && !key.empty() && key.size() <= CACHED_PREFIX_DEPTH;
+    if (persistent && cache->lookup(counter.cacheKey(), key, entry)) {
+        counts[key] = entry.solutions;
+        return entry.solutions;
+    }
+
+    CountResult result;
+    if (unit.prefix.empty()) {
+        result = counter.count(1, cache);
+    } else {
+        result = counter.countUnit(unit);
+        if (persistent) cache->store(counter.cacheKey(), key, {result.solutions, result.nodes});
+        if (!persistent && result.nodes < MEMO_MIN_NODES) return result.solutions;
+    }
+    counts[key] = result.solutions;
+    return result.solutions;
+}
+
+uint64_t SolutionIndex::total() {
+    return subtreeCount(WorkUnit());
+}
+
+std::vector<int> SolutionIndex::unrank(uint64_t k) {
+    if (k >= total())
+        throw std::out_of_range("解序号越界: " + std::to_string(k) + "（共 " + std::to_string(total()) + " 个解）");
+
+    // 在每一行按列号从小到大跳过整棵子树，直到 k 落入某个子树
+    WorkUnit node;
+    for (int row = 0; row < n; ++row) {
+        uint32_t avail = full & ~(node.cols | node.ld | node.rd);
+        while (avail) {
+            uint32_t bit = lowestBit(avail);
+            avail ^= bit;
+            WorkUnit next = child(node, bit);
+            uint64_t size = subtreeCount(next);
+            if (k < size) {
+                node = std::move(next);
+                break;
+            }
+            k -= size;
+        }
+    }
+    return node.prefix;
+}
+
+uint64_t SolutionIndex::rank(const std::vector<int> &queens) {
+    if ((int)queens.size() != n) throw std::invalid_argument("解的行数与棋盘大小不符");
+
+    uint64_t index = 0;
+    WorkUnit node;
+    for (int row = 0; row < n; ++row) {
+        int c = queens[row];
+        uint32_t avail = full & ~(node.cols | node.ld | node.rd);
+        if (c < 0 || c >= n || !(avail & (1u << c)))
+            throw std::invalid_argument("不是合法的解：第 " + std::to_string(row) + " 行的皇后与上方冲突");
+        // 同一行中列号更小的兄弟子树全部排在前面
+        for (uint32_t smaller = avail & ((1u << c) - 1); smaller; smaller &= smaller - 1)
+            index += subtreeCount(child(node, lowestBit(smaller)));
+        node = child(node, 1u << c);
+    }
+    return index;
+}
+
+void SolutionIndex::warmUp(int depth, int threads) {
+    depth = std::max(0, std::min(depth, n));
+    if (depth == 0) {
+        total();
+        return;
+    }
+
+    // 只需计算第 0 行左半的前缀，右半由镜像得到
+    std::vector<WorkUnit> units = counter.split(depth);
+    // 缓存中已有的前缀小计直接取用，其余并行计数
+    std::vector<CountResult> results(units.size());
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < units.size(); ++i) {
+        CacheEntry entry;
+        const std::vector<int> &prefix = units[i].prefix;
+        if (cache && prefix.size() <= CACHED_PREFIX_DEPTH && cache->lookup(counter.cacheKey(), prefix, entry)) {
+            results[i].solutions = entry.solutions;
+            results[i].nodes = entry.nodes;
+        } else {
+            missing.push_back(i);
+        }
+    }
+    runParallel(threads, missing.size(), [&](size_t i, int) {
+        results[missing[i]] = counter.countUnit(units[missing[i]]);
+    });
+
+    // 叶前缀直接记录，上层前缀由子前缀汇总；空前缀即总解数，需乘对称权重
+    std::map<std::vector<int>, CacheEntry> sums;
+    uint64_t solutions = 0;
+    for (size_t i = 0; i < units.size(); ++i) {
+        const std::vector<int> &prefix = units[i].prefix;
+        for (size_t d = 1; d <= prefix.size(); ++d) {
+            CacheEntry &sum = sums[std::vector<int>(prefix.begin(), prefix.begin() + d)];
+            sum.solutions += results[i].solutions;
+            sum.nodes += results[i].nodes;
+        }
+        solutions += results[i].solutions * units[i].weight;
+    }
+    for (const auto &entry : sums) {
+        remember(entry.first, entry.second.solutions);
+        if (cache && entry.first.size() <= CACHED_PREFIX_DEPTH)
+            cache->store(counter.cacheKey(), canonical(entry.first), entry.second);
+    }
+    remember({}, solutions);
+}
+
+} // namespace Core
+} // namespace NQueens
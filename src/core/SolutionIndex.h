@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "NQueensCounter.h"
+#include "ResultCache.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 按字典序（逐行比较列号）给全部解编号：unrank 直接取第 k 个解，rank 求解的序号。
+		// 自顶向下沿位运算搜索树下降，用各子前缀的子树解数跳过整棵子树。
+		// 子树解数算过一次就记住（很小的子树除外），左右镜像的前缀共用同一个值；
+		// 提供 cache 时与 NQueensCounter 共用前缀小计（第 0 行、第 0/1 行），跨进程复用。非线程安全。
+		class SolutionIndex {
+		public:
+			explicit SolutionIndex(int n, ResultCache *cache = nullptr);
+
+			int size() const { return n; }
+			uint64_t total();
+
+			// k 从 0 开始，k >= total() 时抛出 std::out_of_range
+			std::vector<int> unrank(uint64_t k);
+
+			// queens 不是合法的完整解时抛出 std::invalid_argument
+			uint64_t rank(const std::vector<int> &queens);
+
+			// 预先并行计算前 depth 行全部前缀的子树解数，之后每次查询只需在更深处做小规模计数
+			void warmUp(int depth, int threads = 1);
+
+			size_t cachedPrefixes() const { return counts.size(); }
+
+		private:
+			uint64_t subtreeCount(const WorkUnit &unit);
+			std::vector<int> canonical(const std::vector<int> &prefix) const;
+			void remember(const std::vector<int> &prefix, uint64_t count);
+
+			int n;
+			uint32_t full;
+			NQueensCounter counter;
+			ResultCache *cache;
+			std::map<std::vector<int>, uint64_t> counts;
+		};
+
+	} // namespace Core
+} // namespace NQueens
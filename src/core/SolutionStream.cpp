@@ -0,0 +1,171 @@
+#include "SolutionStream.h"
+#include "Bitops.h"
+#include "FirstSolution.h"
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+void checkSize(int n) {
+    if (n < 1 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+}
+
+struct SearchContext {
+    explicit SearchContext(int n) : n(n), full(fullMask(n)), queens(n, -1) { state.queens.assign(n, -1); }
+
+    int n;
+    uint32_t full;
+    std::vector<int> queens;
+    int solutions = 0;
+    int steps = 0;
+    SolverState state;  // 每一步都改写它再产生其引用，queens 的容量在开始时分配一次
+};
+
+// 改写 ctx.state 为第 row 行第 col 列的试探；按元素复制棋盘，不重新分配
+SolverState &beginStep(SearchContext &ctx, int row, int col) {
+    SolverState &state = ctx.state;
+    state.queens = ctx.queens;
+    state.trialPos = {row, col};
+    state.hasConflict = false;
+    state.solutionFound = false;
+    state.newSolutionsFound = 0;
+    state.isSymmetricBase = false;
+    state.skippedMask = 0;
+    state.solutionsCount = ctx.solutions;
+    state.stepsCount = ctx.steps;
+    return state;
+}
+
+// 从第 row 行开始的完整解，每一层递归是一个生成器
+Generator<std::vector<int>> placeRow(SearchContext &ctx, int row, uint32_t cols, uint32_t ld, uint32_t rd) {
+    if (cols == ctx.full) {
+        co_yield ctx.queens;
+        co_return;
+    }
+    uint32_t avail = ctx.full & ~(cols | ld | rd);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        ctx.queens[row] = bitIndex(bit);
+        for (const auto &q : placeRow(ctx, row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1))
+            co_yield q;
+    }
+}
+
+Generator<std::vector<int>> solutionsFrom(int n) {
+    SearchContext ctx(n);
+    std::vector<int> mirror(n);
+
+    // 第 0 行只搜左半，镜像解直接推导
+    for (int c = 0; c < (n + 1) / 2; ++c) {
+        uint32_t bit = 1u << c;
+        bool hasMirror = !(n % 2 != 0 && c == n / 2);
+        ctx.queens[0] = c;
+        for (const auto &q : placeRow(ctx, 1, bit, bit << 1, bit >> 1)) {
+            co_yield q;
+            if (hasMirror) {
+                for (int r = 0; r < n; ++r) mirror[r] = (n - 1) - q[r];
+                co_yield mirror;
+            }
+        }
+    }
+}
+
+// 逐列试探第 row 行；与原先的状态机一样，回溯后该行保留上一次放置的列直到被覆盖
+Generator<SolverState> traceRow(SearchContext &ctx, int row, uint32_t cols, uint32_t ld, uint32_t rd) {
+    int limit = row == 0 ? (ctx.n + 1) / 2 : ctx.n;
+    for (int c = 0; c < limit; ++c) {
+        ctx.steps++;
+        uint32_t bit = 1u << c;
+
+        SolverState &state = beginStep(ctx, row, c);
+        state.hasConflict = ((cols | ld | rd) & bit) != 0;
+
+        if (state.hasConflict) {
+            co_yield state;
+            continue;
+        }
+
+        ctx.queens[row] = c;
+        if (row == ctx.n - 1) {
+            bool hasMirror = !(ctx.n % 2 != 0 && ctx.queens[0] == ctx.n / 2);
+            state.solutionFound = true;
+            state.newSolutionsFound = hasMirror ? 2 : 1;
+            state.isSymmetricBase = hasMirror;
+            ctx.solutions += state.newSolutionsFound;
+            state.solutionsCount = ctx.solutions;
+            co_yield state;
+        } else {
+            co_yield state;
+            for (const auto &s : traceRow(ctx, row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1))
+                co_yield s;
+        }
+    }
+    ctx.queens[row] = -1;
+}
+
+// 只遍历可放位置：每次取最低位，受攻击的列一次性跳过
+Generator<SolverState> traceFreeBits(SearchContext &ctx, int row, uint32_t cols, uint32_t ld, uint32_t rd) {
+    uint32_t limit = row == 0 ? fullMask((ctx.n + 1) / 2) : ctx.full;
+    uint32_t attacked = (cols | ld | rd) & limit;
+    uint32_t avail = limit & ~attacked;
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        int c = bitIndex(bit);
+        ctx.steps++;
+
+        SolverState &state = beginStep(ctx, row, c);
+        state.queens[row] = -1;
+        state.skippedMask = attacked;
+        ctx.queens[row] = c;
+
+        if (row == ctx.n - 1) {
+            bool hasMirror = !(ctx.n % 2 != 0 && ctx.queens[0] == ctx.n / 2);
+            state.solutionFound = true;
+            state.newSolutionsFound = hasMirror ? 2 : 1;
+            state.isSymmetricBase = hasMirror;
+            ctx.solutions += state.newSolutionsFound;
+            state.solutionsCount = ctx.solutions;
+            co_yield state;
+        } else {
+            co_yield state;
+            for (const auto &s : traceFreeBits(ctx, row + 1, cols | bit, (ld | bit) << 1, (rd | bit) >> 1))
+                co_yield s;
+        }
+    }
+    ctx.queens[row] = -1;
+}
+
+Generator<SolverState> stepsFrom(int n, StepMode mode) {
+    if (mode == StepMode::FirstSolution) {
+        FirstSolutionSearch search(n);
+        for (const auto &s : search.steps()) co_yield s;
+        co_return;
+    }
+    SearchContext ctx(n);
+    if (mode == StepMode::FreeBits) {
+        for (const auto &s : traceFreeBits(ctx, 0, 0, 0, 0)) co_yield s;
+    } else {
+        for (const auto &s : traceRow(ctx, 0, 0, 0, 0)) co_yield s;
+    }
+}
+
+} // namespace
+
+Generator<std::vector<int>> solutionStream(int n) {
+    checkSize(n);
+    return solutionsFrom(n);
+}
+
+Generator<SolverState> stepStream(int n, StepMode mode) {
+    checkSize(n);
+    return stepsFrom(n, mode);
+}
+
+} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,19 @@
+#pragma once
+#include <vector>
+#include "common/Types.h"
+#include "Generator.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 惰性产生全部解，顺序与 NQueensSolver 一致（基础解之后紧跟镜像解）。
+		// 产生的引用指向生成器内部缓冲区，可以在任意位置 break 提前结束。
+		Generator<std::vector<int>> solutionStream(int n);
+
+		// 逐步试探事件，与 NQueensSolver::nextStep 返回的状态序列一致（不含最终的完成状态）。
+		// FreeBits 模式每一步都是一次放置，受攻击的列不产生步骤，只记录在 skippedMask 中；
+		// FirstSolution 模式为 FirstSolutionSearch 的放置序列，找到第一个解后结束
+		Generator<SolverState> stepStream(int n, StepMode mode = StepMode::EveryColumn);
+
+	} // namespace Core
+} // namespace NQueens
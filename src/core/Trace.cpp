@@ -0,0 +1,209 @@
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace NQueens {
+namespace Core {
+
+std::atomic<bool> Trace::active{false};
+
+namespace {
+
+// 各字段单独原子读写：读者可能与写者同时访问同一槽，覆盖过的事件按序号丢弃
+struct EventSlot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<const char *> category{nullptr};
+    std::atomic<uint64_t> begin{0};
+    std::atomic<uint64_t> end{0};
+    std::atomic<int64_t> arg{-1};
+};
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(int tid) : tid(tid), slots(new EventSlot[Trace::EVENTS_PER_THREAD]) {}
+
+    int tid;
+    std::string name;  // 由注册表的互斥锁保护
+    std::unique_ptr<EventSlot[]> slots;
+    std::atomic<uint64_t> head{0};  // 已写入的事件总数，只有所属线程修改
+};
+
+struct Event {
+    const char *name;
+    const char *category;
+    uint64_t begin;
+    uint64_t end;
+    int64_t arg;
+};
+
+class Registry {
+public:
+    ThreadBuffer *acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            ThreadBuffer *buffer = idle.back();
+            idle.pop_back();
+            return buffer;
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>((int)buffers.size() + 1));
+        return buffers.back().get();
+    }
+
+    void release(ThreadBuffer *buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(buffer);
+    }
+
+    void rename(ThreadBuffer *buffer, const std::string &name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->name = name;
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer *> idle;
+    std::atomic<uint64_t> sessionBegin{0};
+    std::atomic<uint64_t> sessionEnd{0};  // 0 表示仍在记录
+};
+
+// 故意不析构：线程局部对象在退出时还要归还缓冲区
+Registry &registry() {
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+struct LocalBuffer {
+    ThreadBuffer *buffer = nullptr;
+
+    ThreadBuffer &get() {
+        if (!buffer) buffer = registry().acquire();
+        return *buffer;
+    }
+
+    ~LocalBuffer() {
+        if (buffer) registry().release(buffer);
+    }
+};
+
+thread_local LocalBuffer localBuffer;
+
+void writeEscaped(std::ostream &out, const char *text) {
+    out << '"';
+    for (const char *p = text; *p; ++p) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') out << '\\' << (char)c;
+        else if (c < 0x20) out << ' ';
+        else out << (char)c;
+    }
+    out << '"';
+}
+
+// 纳秒转为 trace-event 使用的微秒
+void writeMicros(std::ostream &out, uint64_t ns) {
+    out << ns / 1000 << '.' << (char)('0' + ns / 100 % 10) << (char)('0' + ns / 10 % 10) << (char)('0' + ns % 10);
+}
+
+} // namespace
+
+void Trace::start() {
+    Registry &r = registry();
+    r.sessionBegin.store(now(), std::memory_order_relaxed);
+    r.sessionEnd.store(0, std::memory_order_relaxed);
+    active.store(true, std::memory_order_release);
+}
+
+void Trace::stop() {
+    active.store(false, std::memory_order_release);
+    registry().sessionEnd.store(now(), std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const std::string &name) {
+    if (!enabled()) return;
+    registry().rename(&localBuffer.get(), name);
+}
+
+uint64_t Trace::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char *name, const char *category, uint64_t begin, uint64_t end, int64_t arg) {
+    ThreadBuffer &buffer = localBuffer.get();
+    uint64_t h = buffer.head.load(std::memory_order_relaxed);
+    EventSlot &slot = buffer.slots[h % EVENTS_PER_THREAD];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    buffer.head.store(h + 1, std::memory_order_release);
+}
+
+void Trace::write(std::ostream &out) {
+    Registry &r = registry();
+    uint64_t sessionBegin = r.sessionBegin.load(std::memory_order_relaxed);
+    uint64_t sessionEnd = r.sessionEnd.load(std::memory_order_relaxed);
+    if (!sessionEnd) sessionEnd = now();
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    uint64_t lost = 0;
+    std::vector<Event> events;
+    for (const auto &buffer : r.buffers) {
+        // 先读 head 再复制，复制后再读一次 head：期间被写者绕回覆盖的槽丢弃
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t from = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (uint64_t i = from; i < head; ++i) {
+            const EventSlot &slot = buffer->slots[i % EVENTS_PER_THREAD];
+            events.push_back({slot.name.load(std::memory_order_relaxed), slot.category.load(std::memory_order_relaxed),
+                              slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed),
+                              slot.arg.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer->head.load(std::memory_order_relaxed);
+        uint64_t valid = after > EVENTS_PER_THREAD ? after - EVENTS_PER_THREAD : 0;
+        size_t skip = valid > from ? (size_t)std::min(valid - from, head - from) : 0;
+        lost += from + skip;
+
+        if (!buffer->name.empty()) {
+            out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":";
+            writeEscaped(out, buffer->name.c_str());
+            out << "}}";
+            first = false;
+        }
+        for (size_t i = skip; i < events.size(); ++i) {
+            const Event &e = events[i];
+            if (e.begin < sessionBegin || e.end > sessionEnd) continue;
+            out << (first ? "" : ",") << "\n{\"name\":";
+            writeEscaped(out, e.name);
+            out << ",\"cat\":";
+            writeEscaped(out, e.category);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicros(out, e.begin - sessionBegin);
+            out << ",\"dur\":";
+            writeMicros(out, e.end - e.begin);
+            if (e.arg >= 0) out << ",\"args\":{\"id\":" << e.arg << '}';
+            out << '}';
+            first = false;
+        }
+    }
+    out << "\n],\"otherData\":{\"overwrittenEvents\":" << lost << "}}\n";
+}
+
+void Trace::save(const std::string &path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("无法写入时间线文件: " + path);
+    write(out);
+    out.flush();
+    if (!out) throw std::runtime_error("写入时间线文件失败: " + path);
+}
+
+} // namespace Core
+} // namespace NQueens
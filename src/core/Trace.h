@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace NQueens {
+	namespace Core {
+
+		// Chrome / Perfetto 时间线（trace-event JSON）。
+		// 每个线程写自己的环形缓冲区，写入不加锁也不等待；未开始记录时每个计量点只剩一次原子读。
+		// 每个线程保留最近 EVENTS_PER_THREAD 个事件，线程退出后缓冲区留给之后创建的线程复用，
+		// 因此时间线上的一条轨道可能先后对应多个系统线程（工作线程池每次调用都会新建线程）
+		class Trace {
+		public:
+			static constexpr uint64_t EVENTS_PER_THREAD = 1 << 15;
+
+			// 开始记录；导出时只包含 start 之后完成的事件
+			static void start();
+			static void stop();
+			static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+			// 当前线程在时间线上的名字；只在记录时生效，避免为不记录的线程分配缓冲区
+			static void setThreadName(const std::string &name);
+
+			// 单调时钟，纳秒
+			static uint64_t now();
+
+			// name 与 category 须为静态存储期的字符串（通常是字面量），导出时才读取；
+			// arg 非负时作为事件参数 id 导出
+			static void record(const char *name, const char *category, uint64_t begin, uint64_t end, int64_t arg = -1);
+
+			// 导出本次记录的全部事件，可以在记录过程中调用
+			static void write(std::ostream &out);
+			static void save(const std::string &path);
+
+		private:
+			static std::atomic<bool> active;
+		};
+
+		// 作用域计量：构造时未在记录则析构时什么也不做
+		class TraceScope {
+		public:
+			TraceScope(const char *name, const char *category, int64_t arg = -1)
+				: name(name), category(category), arg(arg), armed(Trace::enabled()), begin(armed ? Trace::now() : 0) {}
+			~TraceScope() {
+				if (armed) Trace::record(name, category, begin, Trace::now(), arg);
+			}
+			TraceScope(const TraceScope &) = delete;
+			TraceScope &operator=(const TraceScope &) = delete;
+
+		private:
+			const char *name;
+			const char *category;
+			int64_t arg;
+			bool armed;
+			uint64_t begin;
+		};
+
+	} // namespace Core
+} // namespace NQueens
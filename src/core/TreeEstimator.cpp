@@ -0,0 +1,151 @@
+#include "TreeEstimator.h"
+#include "Bitops.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+// 每个线程期望分到的工作单元数，过少时负载不均
+const double UNITS_PER_THREAD = 16.0;
+}
+
+TreeEstimator::TreeEstimator(int n, uint64_t seed) : n(n), seed(seed) {
+    if (n < 1 || n > MAX_BOARD_SIZE)
+        throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+    rowMasks.assign(n, fullMask(n));
+}
+
+TreeEstimator::TreeEstimator(int n, std::vector<uint32_t> rowMasks, uint64_t seed) : TreeEstimator(n, seed) {
+    if ((int)rowMasks.size() != n)
+        throw std::invalid_argument("约束的行数与棋盘大小不符");
+    this->rowMasks = std::move(rowMasks);
+    const uint32_t full = fullMask(n);
+    mirror = std::all_of(this->rowMasks.begin(), this->rowMasks.end(), [full](uint32_t m) { return m == full; });
+}
+
+TreeEstimate TreeEstimator::probe(int row, uint32_t cols, uint32_t ld, uint32_t rd, int probes) const {
+    TreeEstimate est;
+    est.levelWidth.assign(n + 1, 0.0);
+    est.levelWidth[row] = 1.0;
+    probes = std::max(1, probes);
+
+    const uint32_t half = fullMask((n + 1) / 2);
+    std::mt19937_64 rng(seed);
+
+    for (int p = 0; p < probes; ++p) {
+        double weight = 1.0;
+        uint32_t c = cols, l = ld, r = rd;
+        for (int i = row; i < n; ++i) {
+            est.trials += weight * (i == 0 ? (n + 1) / 2 : n);
+
+            uint32_t avail = rowMasks[i] & ~(c | l | r);
+            if (i == 0 && mirror) avail &= half;
+            int branches = popCount(avail);
+            if (branches == 0) break;
+            weight *= branches;
+            est.nodes += weight;
+            est.levelWidth[i + 1] += weight;
+
+            // 均匀地选取其中一个可放位置继续向下
+            int pick = (int)(rng() % (uint64_t)branches);
+            while (pick--) avail &= avail - 1;
+            uint32_t bit = lowestBit(avail);
+            c |= bit;
+            l = (l | bit) << 1;
+            r = (r | bit) >> 1;
+            if (i + 1 == n) est.solutions += weight;
+        }
+    }
+
+    est.nodes /= probes;
+    est.trials /= probes;
+    est.solutions /= probes;
+    for (int d = row + 1; d <= n; ++d) est.levelWidth[d] /= probes;
+    return est;
+}
+
+TreeEstimate TreeEstimator::estimate(int probes) const {
+    return probe(0, 0, 0, 0, probes);
+}
+
+TreeEstimate TreeEstimator::estimateUnit(const WorkUnit &unit, int probes) const {
+    return probe((int)unit.prefix.size(), unit.cols, unit.ld, unit.rd, probes);
+}
+
+int TreeEstimator::chooseSplitDepth(int threads, int probes) const {
+    if (threads <= 1) return 1;
+    TreeEstimate est = estimate(probes);
+    double wanted = threads * UNITS_PER_THREAD;
+    for (int d = 1; d < n; ++d) {
+        if (est.levelWidth[d] >= wanted) return d;
+    }
+    return std::max(1, n - 1);
+}
+
+double TreeEstimator::measureNodeRate() {
+    // 以完整搜索树的节点数计速：计时用默认内核（含残局表），节点数取逐行搜索到底的值
+    static const double rate = []() {
+        uint64_t fullNodes = NQueensCounter(12, 0).count(1).nodes;
+        auto start = std::chrono::steady_clock::now();
+        NQueensCounter(12).count(1);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return fullNodes / std::max(seconds, 1e-6);
+    }();
+    return rate;
+}
+
+RunProgress::RunProgress(std::vector<double> unitEstimates) {
+    reset(std::move(unitEstimates));
+}
+
+void RunProgress::reset(std::vector<double> unitEstimates) {
+    std::lock_guard<std::mutex> lock(mutex);
+    estimates = std::move(unitEstimates);
+    finished.assign(estimates.size(), false);
+    doneSum = 0;
+    pendingSum = 0;
+    for (double e : estimates) pendingSum += e;
+}
+
+void RunProgress::complete(size_t unit, double actual) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (unit >= estimates.size() || finished[unit]) return;
+    finished[unit] = true;
+    pendingSum -= estimates[unit];
+    doneSum += actual;
+}
+
+double RunProgress::total() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return doneSum + std::max(0.0, pendingSum);
+}
+
+double RunProgress::done() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return doneSum;
+}
+
+double RunProgress::remaining() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::max(0.0, pendingSum);
+}
+
+double RunProgress::fraction() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    double all = doneSum + std::max(0.0, pendingSum);
+    return all > 0 ? doneSum / all : 0.0;
+}
+
+double RunProgress::etaSeconds(double elapsedSeconds) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (doneSum <= 0) return -1.0;
+    return elapsedSeconds * std::max(0.0, pendingSum) / doneSum;
+}
+
+} // namespace Core
+} // namespace NQueens
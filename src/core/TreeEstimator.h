@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "NQueensCounter.h"
+
+namespace NQueens {
+	namespace Core {
+
+		struct TreeEstimate {
+			double nodes = 0;                // 放置皇后的次数（NQueensCounter 的节点数）
+			double trials = 0;               // 逐列试探次数（NQueensSolver 的步数）
+			double solutions = 0;            // 搜索范围内的基础解个数（不乘对称权重）
+			std::vector<double> levelWidth;  // 每一行的估计节点数，levelWidth[d] 为前 d 行的部分解个数
+		};
+
+		// Knuth 随机探测估计：沿同一位运算搜索树随机走到底，用分支数乘积估计树的规模
+		class TreeEstimator {
+		public:
+			explicit TreeEstimator(int n, uint64_t seed = 0x9E3779B97F4A7C15ull);
+			// 有约束的搜索树：rowMasks[r] 为第 r 行允许的列（同 NQueensCounter），探测时与可放位置相与；
+			// 掩码不全满时第 0 行不再只取左半
+			TreeEstimator(int n, std::vector<uint32_t> rowMasks, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+			// 整棵搜索树（第 0 行只取左半，与计数器和 NQueensSolver 一致）
+			TreeEstimate estimate(int probes) const;
+
+			// 单个工作单元下的子树
+			TreeEstimate estimateUnit(const WorkUnit &unit, int probes) const;
+
+			// 选择并行切分深度：使每个线程平均分到足够多的工作单元
+			int chooseSplitDepth(int threads, int probes = 256) const;
+
+			// 在本机上测量单线程计数速度（完整搜索树的节点/秒）
+			static double measureNodeRate();
+
+		private:
+			TreeEstimate probe(int row, uint32_t cols, uint32_t ld, uint32_t rd, int probes) const;
+
+			int n;
+			uint64_t seed;
+			std::vector<uint32_t> rowMasks;
+			bool mirror = true;
+		};
+
+		// 运行中的进度模型：初始为各单元的估计值，单元完成后替换为实际值
+		class RunProgress {
+		public:
+			RunProgress() = default;
+			explicit RunProgress(std::vector<double> unitEstimates);
+
+			void reset(std::vector<double> unitEstimates);
+			void complete(size_t unit, double actual);
+
+			double total() const;
+			double done() const;
+			double remaining() const;
+			double fraction() const;
+
+			// 按已用时间和已完成比例推算剩余秒数，尚无完成单元时返回负数
+			double etaSeconds(double elapsedSeconds) const;
+
+		private:
+			mutable std::mutex mutex;
+			std::vector<double> estimates;
+			std::vector<bool> finished;
+			double doneSum = 0;
+			double pendingSum = 0;
+		};
+
+	} // namespace Core
+} // namespace NQueens
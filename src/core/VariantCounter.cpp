@@ -0,0 +1,167 @@
+#include "VariantCounter.h"
+#include "Bitops.h"
+#include "Parallel.h"
+#include <stdexcept>
+#include <vector>
+
+namespace NQueens {
+namespace Core {
+
+namespace {
+
+// 搜索到第 row 行时的攻击状态；near / far 为上一行、上两行棋子的位置，只有马步攻击用到
+struct AttackState {
+    uint32_t cols = 0;
+    uint32_t ld = 0;
+    uint32_t rd = 0;
+    uint32_t near = 0;
+    uint32_t far = 0;
+};
+
+// 各策略提供 blocked（本行受攻击的列）与 place（在 bit 处落子后下一行的状态）
+
+struct QueensPolicy {
+    static uint32_t blocked(const AttackState &s, int) { return s.cols | s.ld | s.rd; }
+    static AttackState place(const AttackState &s, uint32_t bit, int) {
+        return {s.cols | bit, (s.ld | bit) << 1, (s.rd | bit) >> 1, 0, 0};
+    }
+};
+
+// 对角线绕到另一侧：移出的位从另一端移入
+struct ToroidalPolicy {
+    static uint32_t blocked(const AttackState &s, int) { return s.cols | s.ld | s.rd; }
+    static AttackState place(const AttackState &s, uint32_t bit, int n) {
+        uint32_t ld = s.ld | bit;
+        uint32_t rd = s.rd | bit;
+        return {s.cols | bit, ((ld << 1) | (ld >> (n - 1))) & fullMask(n), (rd >> 1) | ((rd & 1u) << (n - 1)), 0, 0};
+    }
+};
+
+// 皇后加马步：上一行棋子攻击相距两列的格子，上两行棋子攻击相距一列的格子
+struct SuperqueensPolicy {
+    static uint32_t blocked(const AttackState &s, int) {
+        return s.cols | s.ld | s.rd | (s.near << 2) | (s.near >> 2) | (s.far << 1) | (s.far >> 1);
+    }
+    static AttackState place(const AttackState &s, uint32_t bit, int) {
+        return {s.cols | bit, (s.ld | bit) << 1, (s.rd | bit) >> 1, bit, s.near};
+    }
+};
+
+struct RooksPolicy {
+    static uint32_t blocked(const AttackState &s, int) { return s.cols; }
+    static AttackState place(const AttackState &s, uint32_t bit, int) { return {s.cols | bit, 0, 0, 0, 0}; }
+};
+
+struct BishopsPolicy {
+    static uint32_t blocked(const AttackState &s, int) { return s.ld | s.rd; }
+    static AttackState place(const AttackState &s, uint32_t bit, int) {
+        return {0, (s.ld | bit) << 1, (s.rd | bit) >> 1, 0, 0};
+    }
+};
+
+template <class Policy>
+uint64_t countFrom(int n, uint32_t full, int row, const AttackState &s, uint64_t &nodes) {
+    if (row == n) return 1;
+    uint64_t total = 0;
+    uint32_t avail = full & ~Policy::blocked(s, n);
+    while (avail) {
+        uint32_t bit = lowestBit(avail);
+        avail ^= bit;
+        nodes++;
+        total += countFrom<Policy>(n, full, row + 1, Policy::place(s, bit, n), nodes);
+    }
+    return total;
+}
+
+// 以前两行的放法为工作单元：第 0 行只取左半，奇数 n 的中列权重为 1
+template <class Policy>
+CountResult countVariant(int n, int threads) {
+    const uint32_t full = fullMask(n);
+    struct Unit {
+        int row;
+        AttackState state;
+        uint64_t weight;
+    };
+    std::vector<Unit> units;
+    CountResult result;
+    for (int c = 0; c < (n + 1) / 2; ++c) {
+        uint32_t bit = 1u << c;
+        uint64_t weight = (n % 2 != 0 && c == n / 2) ? 1 : 2;
+        AttackState first = Policy::place(AttackState(), bit, n);
+        result.nodes++;
+        if (n == 1) {
+            units.push_back({1, first, weight});
+            continue;
+        }
+        uint32_t avail = full & ~Policy::blocked(first, n);
+        while (avail) {
+            uint32_t next = lowestBit(avail);
+            avail ^= next;
+            result.nodes++;
+            units.push_back({2, Policy::place(first, next, n), weight});
+        }
+    }
+
+    std::vector<uint64_t> solutions(units.size());
+    std::vector<uint64_t> nodes(units.size());
+    runParallel(threads, units.size(), [&](size_t i, int) {
+        solutions[i] = units[i].weight * countFrom<Policy>(n, full, units[i].row, units[i].state, nodes[i]);
+    });
+    for (size_t i = 0; i < units.size(); ++i) {
+        result.solutions += solutions[i];
+        result.nodes += nodes[i];
+    }
+    return result;
+}
+
+} // namespace
+
+const char *variantName(Variant variant) {
+    switch (variant) {
+    case Variant::Queens: return "queens";
+    case Variant::Toroidal: return "toroidal";
+    case Variant::Superqueens: return "superqueens";
+    case Variant::Rooks: return "rooks";
+    case Variant::Bishops: return "bishops";
+    }
+    return "queens";
+}
+
+Variant parseVariant(const std::string &name) {
+    for (Variant v : {Variant::Queens, Variant::Toroidal, Variant::Superqueens, Variant::Rooks, Variant::Bishops})
+        if (name == variantName(v)) return v;
+    throw std::invalid_argument("未知变体: " + name + "（可选 queens | toroidal | superqueens | rooks | bishops）");
+}
+
+VariantCounter::VariantCounter(int n, Variant variant) : n(n), kind(variant) {
+    if (n < 1 || n > MAX_BOARD_SIZE) throw std::invalid_argument("棋盘大小超出范围: " + std::to_string(n));
+}
+
+CacheKey VariantCounter::cacheKey() const {
+    CacheKey key;
+    key.engine = "policy";
+    key.variant = variantName(kind);
+    key.n = n;
+    key.engineVersion = ENGINE_VERSION;
+    return key;
+}
+
+CountResult VariantCounter::count(int threads, ResultCache *cache) const {
+    CacheEntry entry;
+    if (cache && cache->lookup(cacheKey(), {}, entry)) return {entry.solutions, entry.nodes};
+
+    CountResult result;
+    switch (kind) {
+    case Variant::Queens: result = countVariant<QueensPolicy>(n, threads); break;
+    case Variant::Toroidal: result = countVariant<ToroidalPolicy>(n, threads); break;
+    case Variant::Superqueens: result = countVariant<SuperqueensPolicy>(n, threads); break;
+    case Variant::Rooks: result = countVariant<RooksPolicy>(n, threads); break;
+    case Variant::Bishops: result = countVariant<BishopsPolicy>(n, threads); break;
+    }
+
+    if (cache) cache->store(cacheKey(), {}, {result.solutions, result.nodes});
+    return result;
+}
+
+} // namespace Core
+} // namespace NQueens
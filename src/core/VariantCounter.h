@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "NQueensCounter.h"
+#include "ResultCache.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 每行恰好放一个棋子的变体，区别只在攻击掩码的更新方式：
+		// Toroidal 棋盘左右相接，对角线用循环移位；Superqueens 另带马步攻击，需要回看前两行；
+		// Rooks / Bishops 只保留列或对角线约束，用作基准对照
+		enum class Variant { Queens, Toroidal, Superqueens, Rooks, Bishops };
+
+		const char *variantName(Variant variant);
+		// 未知名称抛出 invalid_argument
+		Variant parseVariant(const std::string &name);
+
+		// 策略模板化的计数内核：每种变体实例化出独立的搜索循环，热路径上不按变体分支。
+		// 所有变体都在左右翻转下对称，第 0 行只搜左半
+		class VariantCounter {
+		public:
+			static constexpr uint32_t ENGINE_VERSION = 1;
+
+			VariantCounter(int n, Variant variant);
+
+			Variant variant() const { return kind; }
+
+			// nodes 为放置的棋子数
+			CountResult count(int threads = 1, ResultCache *cache = nullptr) const;
+
+			CacheKey cacheKey() const;
+
+		private:
+			int n;
+			Variant kind;
+		};
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,17 @@
+#include "WorkerMonitor.h"
+#include <algorithm>
+
+namespace NQueens {
+namespace Core {
+
+WorkerMonitor::WorkerMonitor(int workers)
+    : count(std::max(1, workers)), slots(new Seqlock<WorkerSnapshot>[std::max(1, workers)]) {}
+
+void WorkerMonitor::reset(int n) {
+    WorkerSnapshot empty;
+    empty.n = n;
+    for (int i = 0; i < count; ++i) slots[i].store(empty);
+}
+
+} // namespace Core
+} // namespace NQueens
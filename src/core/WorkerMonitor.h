@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "Bitops.h"
+#include "Seqlock.h"
+
+namespace NQueens {
+	namespace Core {
+
+		// 单个工作线程对外发布的状态
+		struct WorkerSnapshot {
+			int32_t n = 0;
+			int32_t depth = 0;                 // queens 中有效的行数（当前部分棋盘）
+			int8_t queens[MAX_BOARD_SIZE] = {};
+			bool active = false;               // 正在执行工作单元
+			uint32_t unitsDone = 0;
+			uint64_t nodes = 0;
+			uint64_t solutions = 0;            // 已完成工作单元的解数（含对称权重）
+		};
+
+		// 每个工作线程一个顺序锁槽：工作线程周期性写入，界面线程随时无锁采样
+		class WorkerMonitor {
+		public:
+			explicit WorkerMonitor(int workers);
+
+			int size() const { return count; }
+
+			void publish(int worker, const WorkerSnapshot &snapshot) { slots[worker].store(snapshot); }
+			bool sample(int worker, WorkerSnapshot &out) const { return slots[worker].load(out); }
+			uint32_t version(int worker) const { return slots[worker].version(); }
+
+			// 开始新一轮搜索前清空所有槽
+			void reset(int n);
+
+		private:
+			int count;
+			std::unique_ptr<Seqlock<WorkerSnapshot>[]> slots;
+		};
+
+	} // namespace Core
+} // namespace NQueens
@@ -0,0 +1,12 @@
+#include <QApplication>
+#include "ui/MainWindow.h"
+
+int main(int argc, char *argv[]) {
+    QApplication::setHighDpiScaleFactorRoundingPolicy(Qt::HighDpiScaleFactorRoundingPolicy::PassThrough);
+    QApplication app(argc, argv);
+
+    NQueens::UI::MainWindow window;
+    window.show();
+
+    return app.exec();
+}
@@ -1,6 +1,10 @@
 #include "ChessboardWidget.h"
+#include "core/Trace.h"
 #include <QPainter>
 #include <QEasingCurve>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <algorithm>
 #include <cmath>
 
 namespace NQueens {
@@ -9,9 +13,10 @@ namespace UI {
 using namespace NQueens::Config;
 
 ChessboardWidget::ChessboardWidget(int size, QWidget *parent)
-    : QWidget(parent), boardSize(size), animatedRadius(0), cellSize(INITIAL_CELL_SIZE) {
+    : QWidget(parent), boardSize(size), animatedRadius(0), cellSize(INITIAL_CELL_SIZE), heatmapVisible(false),
+      skippedVisible(false), perf(nullptr), perfHudVisible(false), editable(false) {
     
-    boardState.queens.fill(-1, size);
+    boardState.queens.assign(size, -1);
     boardState.trialPos = {-1, -1};
 
     animation = new QVariantAnimation(this);
@@ -26,13 +31,14 @@ ChessboardWidget::ChessboardWidget(int size, QWidget *parent)
 
 void ChessboardWidget::setBoardSize(int size) {
     boardSize = size;
-    boardState.queens.fill(-1, size);
+    heatmap.clear();
+    boardState.queens.assign(size, -1);
     boardState.trialPos = {-1, -1};
     resizeEvent(nullptr);
     update();
 }
 
-void ChessboardWidget::setQueensManually(const QVector<int>& queens) {
+void ChessboardWidget::setQueensManually(const std::vector<int>& queens) {
     boardState.queens = queens;
     boardState.trialPos = {-1, -1};
     boardState.hasConflict = false;
@@ -44,7 +50,7 @@ void ChessboardWidget::setAnimationSpeed(int durationMs) {
 }
 
 void ChessboardWidget::setState(const SolverState &state) {
-    QPair<int, int> oldTrialPos = currentTrialPos;
+    std::pair<int, int> oldTrialPos = currentTrialPos;
     boardState = state;
     currentTrialPos = state.trialPos;
 
@@ -58,6 +64,47 @@ void ChessboardWidget::setState(const SolverState &state) {
     update();
 }
 
+void ChessboardWidget::setHeatmap(const std::vector<uint64_t> &cells) {
+    heatmap = cells;
+    update();
+}
+
+void ChessboardWidget::setHeatmapVisible(bool visible) {
+    heatmapVisible = visible;
+    update();
+}
+
+void ChessboardWidget::setSkippedVisible(bool visible) {
+    skippedVisible = visible;
+    update();
+}
+
+void ChessboardWidget::setEditable(bool editable) {
+    this->editable = editable;
+    setCursor(editable ? Qt::PointingHandCursor : Qt::ArrowCursor);
+}
+
+void ChessboardWidget::mousePressEvent(QMouseEvent *event) {
+    if (!editable || event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    QPointF pos = event->position();
+    int col = int(std::floor((pos.x() - boardOffsetX) / cellSize));
+    int row = int(std::floor((pos.y() - boardOffsetY) / cellSize));
+    if (row >= 0 && row < boardSize && col >= 0 && col < boardSize) emit cellClicked(row, col);
+}
+
+void ChessboardWidget::setPerfMonitor(PerfMonitor *monitor) {
+    perf = monitor;
+    update();
+}
+
+void ChessboardWidget::setPerfHudVisible(bool visible) {
+    perfHudVisible = visible;
+    update();
+}
+
 void ChessboardWidget::setAnimatedRadius(qreal r) {
     animatedRadius = r;
     update();
@@ -73,20 +120,90 @@ void ChessboardWidget::resizeEvent(QResizeEvent *event) {
 
 void ChessboardWidget::paintEvent(QPaintEvent *event) {
     Q_UNUSED(event);
+    Core::TraceScope trace("paint", "ui");
+    if (perf) perf->markFrame();
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
-    // 绘制棋盘
+    {
+        PerfScope scope(perf, PerfMonitor::PaintTime);
+        if (perf) perf->startPaintCounters();
+        // 绘制棋盘
+        for (int r = 0; r < boardSize; ++r) {
+            for (int c = 0; c < boardSize; ++c) {
+                QRectF rect(boardOffsetX + c * cellSize,
+                            boardOffsetY + r * cellSize,
+                            cellSize, cellSize);
+                QColor color = ((r + c) % 2 == 0) ? Colors::LightSquare : Colors::DarkSquare;
+                painter.fillRect(rect, color);
+            }
+        }
+        if (heatmapVisible) drawHeatmap(painter);
+        if (skippedVisible) drawSkipped(painter);
+        drawQueens(painter);
+        if (perf) perf->stopPaintCounters(boardSize * boardSize);
+    }
+    if (perf && perfHudVisible) drawPerfHud(painter);
+}
+
+void ChessboardWidget::drawPerfHud(QPainter &painter) {
+    QStringList lines = perf->summary();
+    QFont font = painter.font();
+    font.setBold(false);
+    font.setPixelSize(12);
+    painter.setFont(font);
+    QFontMetrics metrics(font);
+    int width = 0;
+    for (const QString &line : lines) width = std::max(width, metrics.horizontalAdvance(line));
+    int lineHeight = metrics.height();
+
+    QRectF box(8, 8, width + 16, lineHeight * lines.size() + 12);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(15, 23, 42, 190));
+    painter.drawRoundedRect(box, 6, 6);
+    painter.setPen(Colors::Bg);
+    for (int i = 0; i < lines.size(); ++i)
+        painter.drawText(QPointF(box.left() + 8, box.top() + 6 + metrics.ascent() + i * lineHeight), lines[i]);
+}
+
+void ChessboardWidget::drawHeatmap(QPainter &painter) {
+    if (heatmap.size() != size_t(boardSize) * boardSize) return;
+    uint64_t maxCount = *std::max_element(heatmap.begin(), heatmap.end());
+    if (maxCount == 0) return;
+
+    // 按占用次数相对最大值着色，格子足够大时标出占全部解的比例
+    uint64_t solutions = 0;
+    for (int c = 0; c < boardSize; ++c) solutions += heatmap[c];
+    QFont font = painter.font();
+    font.setPixelSize(std::max(8, int(cellSize / 5)));
+    painter.setFont(font);
     for (int r = 0; r < boardSize; ++r) {
         for (int c = 0; c < boardSize; ++c) {
-            QRectF rect(boardOffsetX + c * cellSize,
-                        boardOffsetY + r * cellSize,
-                        cellSize, cellSize);
-            QColor color = ((r + c) % 2 == 0) ? Colors::LightSquare : Colors::DarkSquare;
+            uint64_t count = heatmap[r * boardSize + c];
+            QRectF rect(boardOffsetX + c * cellSize, boardOffsetY + r * cellSize, cellSize, cellSize);
+            QColor color = Colors::Heatmap;
+            color.setAlphaF(0.85 * double(count) / double(maxCount));
             painter.fillRect(rect, color);
+            if (cellSize >= 36 && solutions) {
+                painter.setPen(Colors::TextPrimary);
+                painter.drawText(rect.adjusted(2, 2, -2, -2), Qt::AlignRight | Qt::AlignBottom,
+                                 QString::number(100.0 * count / solutions, 'f', 1) + "%");
+            }
         }
     }
-    drawQueens(painter);
+}
+
+void ChessboardWidget::drawSkipped(QPainter &painter) {
+    int r = boardState.trialPos.first;
+    if (r < 0 || boardState.skippedMask == 0) return;
+    QColor shade = Colors::Skipped;
+    shade.setAlphaF(0.25);
+    for (int c = 0; c < boardSize; ++c) {
+        if (!(boardState.skippedMask & (1u << c))) continue;
+        QRectF rect(boardOffsetX + c * cellSize, boardOffsetY + r * cellSize, cellSize, cellSize);
+        painter.fillRect(rect, shade);
+        painter.fillRect(rect, QBrush(Colors::Skipped, Qt::BDiagPattern));
+    }
 }
 
 void ChessboardWidget::drawQueens(QPainter &painter) {
@@ -97,7 +214,7 @@ void ChessboardWidget::drawQueens(QPainter &painter) {
     painter.setFont(font);
 
     // 绘制已放置
-    for (int r = 0; r < boardState.queens.size(); ++r) {
+    for (int r = 0; r < (int)boardState.queens.size(); ++r) {
         int c = boardState.queens[r];
         if (c != -1) {
             qreal radius = cellSize / 2.2;
@@ -3,6 +3,7 @@
 #include <QVariantAnimation>
 #include "common/Types.h"
 #include "common/Config.h"
+#include "ui/PerfMonitor.h"
 
 namespace NQueens {
 	namespace UI {
@@ -15,28 +16,56 @@ namespace NQueens {
 			explicit ChessboardWidget(int size, QWidget *parent = nullptr);
 
 			void setBoardSize(int size);
-			void setQueensManually(const QVector<int>& queens);
+			void setQueensManually(const std::vector<int>& queens);
 			void setAnimationSpeed(int durationMs);
 			void setState(const SolverState &state);
 
+			// 热力图叠加层：cells 为行优先的逐格占用次数，大小须为 boardSize²
+			void setHeatmap(const std::vector<uint64_t> &cells);
+			void setHeatmapVisible(bool visible);
+			bool isHeatmapVisible() const { return heatmapVisible; }
+
+			// 逐位步进时把试探行中被跳过的受攻击格子画成阴影
+			void setSkippedVisible(bool visible);
+
+			// 可编辑时单击格子发出 cellClicked，由外部决定如何摆放
+			void setEditable(bool editable);
+
+			// 性能计量：monitor 为空时不做任何计时；hudVisible 控制是否在棋盘上叠加显示
+			void setPerfMonitor(PerfMonitor *monitor);
+			void setPerfHudVisible(bool visible);
+
 			qreal getAnimatedRadius() const { return animatedRadius; }
 			void setAnimatedRadius(qreal r);
 
+		signals:
+			void cellClicked(int row, int col);
+
 		protected:
+			void mousePressEvent(QMouseEvent *event) override;
 			void resizeEvent(QResizeEvent *event) override;
 			void paintEvent(QPaintEvent *event) override;
 
 		private:
+			void drawHeatmap(QPainter &painter);
+			void drawSkipped(QPainter &painter);
 			void drawQueens(QPainter &painter);
+			void drawPerfHud(QPainter &painter);
 			void drawSingleQueen(QPainter &painter, qreal cx, qreal cy, qreal radius, const QColor &color, const QString &text);
 
 			int boardSize;
 			SolverState boardState;
-			QPair<int, int> currentTrialPos;
+			std::pair<int, int> currentTrialPos;
 			qreal animatedRadius;
 			qreal cellSize;
 			qreal boardOffsetX, boardOffsetY;
 			QVariantAnimation *animation;
+			std::vector<uint64_t> heatmap;
+			bool heatmapVisible;
+			bool skippedVisible;
+			PerfMonitor *perf;
+			bool perfHudVisible;
+			bool editable;
 		};
 
 	} // namespace UI
@@ -1,18 +1,43 @@
 #include "MainWindow.h"
 #include "common/Config.h"
+#include "core/Trace.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QGroupBox>
+#include <QDockWidget>
 #include <QDir>
+#include <QDateTime>
 #include <QCoreApplication>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
 
 namespace NQueens {
 namespace UI {
 
 using namespace NQueens::Config;
 
-MainWindow::MainWindow() : solver(nullptr), isPaused(false) {
+namespace {
+
+// 每个第 0 行子树的随机探测次数
+const int ESTIMATE_PROBES = 2000;
+
+QString formatDuration(double ms) {
+    qint64 secs = qint64(ms / 1000.0 + 0.5);
+    if (secs < 60) return QString("%1秒").arg(secs);
+    if (secs < 3600) return QString("%1分%2秒").arg(secs / 60).arg(secs % 60);
+    if (secs < 86400) return QString("%1小时%2分").arg(secs / 3600).arg((secs % 3600) / 60);
+    return QString("%1天%2小时").arg(secs / 86400).arg((secs % 86400) / 3600);
+}
+
+} // namespace
+
+MainWindow::MainWindow()
+    : solver(nullptr), isPaused(false), estimatedBaseSolutions(0), baseSolutionsFound(0),
+      currentRootCol(-1), rootStartSteps(0), lastSteps(0), heatmapRequest(0),
+      perf(nullptr), whatIfRequest(0) {
     setWindowTitle("N-Queens Visualizer (Symmetry Pruning)");
     setMinimumSize(800, 800);
 
@@ -22,11 +47,22 @@ MainWindow::MainWindow() : solver(nullptr), isPaused(false) {
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &MainWindow::nextStep);
 
+    perfTimer = new QTimer(this);
+    perfTimer->setInterval(100);
+    connect(perfTimer, &QTimer::timeout, this, &MainWindow::perfTick);
+
+    whatIfTimer = new QTimer(this);
+    whatIfTimer->setInterval(10);
+    connect(whatIfTimer, &QTimer::timeout, this, &MainWindow::pollWhatIf);
+
     updateSpeed("正常速度");
 }
 
 MainWindow::~MainWindow() {
+    cancelWhatIf();
     if (solver) delete solver;
+    chessboard->setPerfMonitor(nullptr);
+    delete perf;
 }
 
 void MainWindow::setupUI() {
@@ -40,7 +76,7 @@ void MainWindow::setupUI() {
 
     controlLayout->addWidget(new QLabel("棋盘大小:"), 0, 0);
     sizeSpin = new QSpinBox();
-    sizeSpin->setRange(4, 14);
+    sizeSpin->setRange(MIN_DEMO_SIZE, MAX_DEMO_SIZE);
     sizeSpin->setValue(DEFAULT_BOARD_SIZE);
     connect(sizeSpin, &QSpinBox::valueChanged, this, &MainWindow::changeBoardSize);
     controlLayout->addWidget(sizeSpin, 0, 1);
@@ -67,22 +103,109 @@ void MainWindow::setupUI() {
 
     statusLabel = new QLabel("点击 '开始演示'。算法将利用对称性只搜索一半棋盘。");
     statsLabel = new QLabel("");
+    etaLabel = new QLabel("");
     controlLayout->addWidget(statusLabel, 1, 0, 1, 3);
-    controlLayout->addWidget(statsLabel, 1, 3, 1, 3);
+    controlLayout->addWidget(statsLabel, 1, 3, 1, 1);
+    controlLayout->addWidget(etaLabel, 1, 4, 1, 2);
+
+    heatmapCheck = new QCheckBox("占用热力图");
+    heatmapCheck->setToolTip("显示每个格子在全部解中放有皇后的比例");
+    connect(heatmapCheck, &QCheckBox::toggled, this, &MainWindow::toggleHeatmap);
+    controlLayout->addWidget(heatmapCheck, 2, 0, 1, 2);
+
+    perfHudCheck = new QCheckBox("性能 HUD");
+    perfHudCheck->setToolTip("在棋盘上显示帧率、绘制耗时、求解步进、事件队列延迟与截图耗时");
+    connect(perfHudCheck, &QCheckBox::toggled, this, &MainWindow::updatePerfMonitoring);
+    controlLayout->addWidget(perfHudCheck, 2, 2, 1, 2);
+
+    perfLogCheck = new QCheckBox("性能日志 (CSV)");
+    perfLogCheck->setToolTip("每秒一行写入可执行文件目录下的 perf_*.csv");
+    connect(perfLogCheck, &QCheckBox::toggled, this, &MainWindow::togglePerfLog);
+    controlLayout->addWidget(perfLogCheck, 2, 4, 1, 2);
+
+    whatIfCheck = new QCheckBox("摆放模式");
+    whatIfCheck->setToolTip("单击格子放置或移除皇后，实时统计当前布局还有多少种完成方式");
+    connect(whatIfCheck, &QCheckBox::toggled, this, &MainWindow::toggleWhatIf);
+    controlLayout->addWidget(whatIfCheck, 3, 0, 1, 2);
+    whatIfLabel = new QLabel("");
+    controlLayout->addWidget(whatIfLabel, 3, 2, 1, 4);
+
+    serviceCheck = new QCheckBox("使用查询服务");
+    serviceCheck->setToolTip("摆放模式的完成数交给 nqueens-cli serve 计算，共享其常驻缓存");
+    connect(serviceCheck, &QCheckBox::toggled, this, [this]() {
+        if (whatIfCheck->isChecked()) restartWhatIf();
+    });
+    controlLayout->addWidget(serviceCheck, 4, 0, 1, 2);
+    serviceEdit = new QLineEdit(qEnvironmentVariable("NQUEENS_SOCKET", "/tmp/nqueens.sock"));
+    serviceEdit->setPlaceholderText("套接字路径");
+    controlLayout->addWidget(serviceEdit, 4, 2, 1, 4);
+
+    stepModeCombo = new QComboBox();
+    stepModeCombo->addItem("逐列试探", int(StepMode::EveryColumn));
+    stepModeCombo->addItem("逐位步进", int(StepMode::FreeBits));
+    stepModeCombo->addItem("启发式首解", int(StepMode::FirstSolution));
+    stepModeCombo->setToolTip("逐列试探：按列号逐个试探每个格子并枚举全部解\n"
+                              "逐位步进：每一步只放在当前行的可放位置上（最低位技巧），受攻击的格子不再逐个试探\n"
+                              "启发式首解：先放可放格子最少的行、候选列从中间向两侧，前向检查失败的放置标红，找到第一个解即结束\n"
+                              "下次开始演示时生效");
+    controlLayout->addWidget(stepModeCombo, 5, 0, 1, 2);
+    skippedCheck = new QCheckBox("显示跳过的格子");
+    skippedCheck->setToolTip("逐位步进时把试探行中被直接跳过的受攻击格子画成阴影");
+    connect(skippedCheck, &QCheckBox::toggled, this, [this](bool visible) { chessboard->setSkippedVisible(visible); });
+    controlLayout->addWidget(skippedCheck, 5, 2, 1, 2);
+
+    traceCheck = new QCheckBox("记录时间线");
+    traceCheck->setToolTip("记录求解线程、绘制、步进与截图的耗时，取消勾选时写入可执行文件目录下的 trace_*.json（Chrome / Perfetto 格式）");
+    connect(traceCheck, &QCheckBox::toggled, this, &MainWindow::toggleTrace);
+    controlLayout->addWidget(traceCheck, 5, 4, 1, 2);
+
+    queryClient = new QueryClient(this);
+    connect(queryClient, &QueryClient::responseReady, this, &MainWindow::handleQueryResponse);
+    connect(queryClient, &QueryClient::failed, this, &MainWindow::handleQueryFailure);
 
     mainLayout->addWidget(controlGroup);
 
     boardSize = DEFAULT_BOARD_SIZE;
     chessboard = new ChessboardWidget(boardSize);
+    connect(chessboard, &ChessboardWidget::cellClicked, this, &MainWindow::placeQueen);
     mainLayout->addWidget(chessboard, 1);
 
     setCentralWidget(centralWidget);
+
+    // 解库面板：演示过程中找到的解依次加入，也可以一次载入当前 N 的全部解
+    gallery = new SolutionGallery;
+    gallery->reset(boardSize);
+    connect(gallery, &SolutionGallery::loadAllRequested, this, [this]() {
+        if (startButton->text() == "停止") {
+            statusLabel->setText("演示进行中，停止后才能载入全部解");
+            return;
+        }
+        gallery->loadAll(boardSize);
+    });
+    connect(gallery, &SolutionGallery::solutionActivated, this, &MainWindow::showGallerySolution);
+    QDockWidget *galleryDock = new QDockWidget("解库", this);
+    galleryDock->setWidget(gallery);
+    galleryDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+    addDockWidget(Qt::RightDockWidgetArea, galleryDock);
+
+    // 并行视图：观察多线程计数时各工作线程的搜索位置
+    QDockWidget *workersDock = new QDockWidget("并行视图", this);
+    workersDock->setWidget(new WorkerBoardsPanel);
+    workersDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+    addDockWidget(Qt::RightDockWidgetArea, workersDock);
+    tabifyDockWidget(galleryDock, workersDock);
+    galleryDock->raise();
 }
 
 void MainWindow::changeBoardSize(int newSize) {
     if (!timer->isActive()) {
         boardSize = newSize;
         chessboard->setBoardSize(newSize);
+        if (heatmapCheck->isChecked()) loadHeatmap();
+        if (whatIfCheck->isChecked()) {
+            whatIfQueens.assign(newSize, -1);
+            restartWhatIf();
+        }
         statusLabel->setText(QString("棋盘大小已改为 %1×%1").arg(newSize));
     }
 }
@@ -91,6 +214,8 @@ void MainWindow::updateSpeed(const QString &speedText) {
     int interval = SPEED_SETTINGS.value(speedText, 100);
     timer->setInterval(interval);
     chessboard->setAnimationSpeed(interval);
+    if (perf) perf->setTimerInterval(interval);
+    if (solver) updateEta();
 }
 
 void MainWindow::toggleSearch() {
@@ -116,14 +241,18 @@ void MainWindow::togglePause() {
 }
 
 void MainWindow::startSearch() {
+    whatIfCheck->setChecked(false);
     if (solver) delete solver;
-    solver = new Core::NQueensSolver(boardSize);
+    solver = new Core::NQueensSolver(boardSize, stepMode());
 
     startButton->setText("停止");
     pauseButton->setEnabled(true);
     sizeSpin->setEnabled(false);
+    stepModeCombo->setEnabled(false);
     statusLabel->setText("正在搜索... (对称优化中)");
     statsLabel->setText("步数: 0");
+    gallery->reset(boardSize);
+    startEstimate();
 
     timer->start();
 }
@@ -139,26 +268,39 @@ void MainWindow::resetUIState(bool finished) {
     pauseButton->setText("暂停");
     isPaused = false;
     sizeSpin->setEnabled(true);
+    stepModeCombo->setEnabled(true);
     if (!finished) {
         SolverState emptyState;
-        emptyState.queens.fill(-1, boardSize);
+        emptyState.queens.assign(boardSize, -1);
         emptyState.trialPos = {-1, -1};
         emptyState.hasConflict = false;
         chessboard->setState(emptyState);
         statusLabel->setText("点击 '开始演示' 启动。");
         statsLabel->setText("");
+        etaLabel->setText("");
     }
 }
 
 void MainWindow::nextStep() {
     if (!solver) return;
+    Core::TraceScope trace("step", "ui");
 
-    SolverState state = solver->nextStep();
+    if (perf) perf->markStep();
+    SolverState state;
+    {
+        PerfScope scope(perf, PerfMonitor::StepTime);
+        state = solver->nextStep();
+    }
     chessboard->setState(state);
+    trackEstimate(state);
 
     if (state.isFinished) {
         timer->stop();
-        statusLabel->setText(QString("完成! 找到 %1 个解 (利用对称性减少了约50%计算)").arg(state.solutionsCount));
+        etaLabel->setText("");
+        if (stepMode() == StepMode::FirstSolution)
+            statusLabel->setText(state.solutionsCount ? QString("完成! 启发式搜索找到第一个解") : QString("完成! 该棋盘无解"));
+        else
+            statusLabel->setText(QString("完成! 找到 %1 个解 (利用对称性减少了约50%计算)").arg(state.solutionsCount));
         statsLabel->setText(QString("计算步数: %1").arg(state.stepsCount));
         resetUIState(true);
         return;
@@ -171,6 +313,248 @@ void MainWindow::nextStep() {
         statusLabel->setText(QString("正在搜索... 已找到 %1 个解").arg(state.solutionsCount));
         statsLabel->setText(QString("步数: %1").arg(state.stepsCount));
     }
+    updateEta();
+}
+
+void MainWindow::showGallerySolution(int size, const std::vector<int> &queens) {
+    if (startButton->text() == "停止") {
+        statusLabel->setText("演示进行中，停止后才能查看解库中的解");
+        return;
+    }
+    if (size != boardSize) sizeSpin->setValue(size);
+    chessboard->setQueensManually(queens);
+    statusLabel->setText(QString("已载入解库中的解 (N=%1)").arg(size));
+}
+
+void MainWindow::toggleHeatmap(bool visible) {
+    chessboard->setHeatmapVisible(visible);
+    if (visible) loadHeatmap();
+}
+
+void MainWindow::loadHeatmap() {
+    // 只采用最后一次请求的结果，期间切换棋盘大小时旧结果直接丢弃
+    int request = ++heatmapRequest;
+    int size = boardSize;
+    QPointer<MainWindow> self(this);
+    QThreadPool::globalInstance()->start([self, request, size]() {
+        std::vector<uint64_t> cells = Core::NQueensCounter(size).occupancy(QThread::idealThreadCount()).cells;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, request, cells]() {
+            if (!self || request != self->heatmapRequest) return;
+            self->chessboard->setHeatmap(cells);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::updatePerfMonitoring() {
+    bool needed = perfHudCheck->isChecked() || perfLogCheck->isChecked();
+    if (needed && !perf) {
+        perf = new PerfMonitor;
+        perf->setTimerInterval(timer->interval());
+        perfTimer->start();
+    } else if (!needed && perf) {
+        perfTimer->stop();
+        chessboard->setPerfMonitor(nullptr);
+        delete perf;
+        perf = nullptr;
+    }
+    chessboard->setPerfMonitor(perf);
+    chessboard->setPerfHudVisible(perfHudCheck->isChecked());
+}
+
+void MainWindow::togglePerfLog(bool enabled) {
+    updatePerfMonitoring();
+    if (!enabled) {
+        if (perf) perf->stopLog();
+        return;
+    }
+    QString path = QString("%1/perf_%2.csv").arg(QCoreApplication::applicationDirPath())
+                       .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if (perf->startLog(path)) {
+        statusLabel->setText("性能日志写入 " + QDir::toNativeSeparators(path));
+    } else {
+        statusLabel->setText("无法创建性能日志 " + QDir::toNativeSeparators(path));
+        perfLogCheck->setChecked(false);
+    }
+}
+
+void MainWindow::toggleTrace(bool enabled) {
+    if (enabled) {
+        Core::Trace::start();
+        Core::Trace::setThreadName("GUI");
+        statusLabel->setText("正在记录时间线，取消勾选后导出。");
+        return;
+    }
+    Core::Trace::stop();
+    QString path = QString("%1/trace_%2.json").arg(QCoreApplication::applicationDirPath())
+                       .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    try {
+        Core::Trace::save(QDir::toNativeSeparators(path).toStdString());
+        statusLabel->setText("时间线已写入 " + QDir::toNativeSeparators(path));
+    } catch (const std::exception &e) {
+        statusLabel->setText(QString::fromStdString(e.what()));
+    }
+}
+
+void MainWindow::perfTick() {
+    if (!perf) return;
+    // 投递一个排队调用，测量它从投递到执行等待了多久，即事件队列的积压
+    PerfMonitor *probe = perf;
+    qint64 posted = probe->now();
+    QMetaObject::invokeMethod(this, [this, probe, posted]() {
+        if (perf == probe) perf->record(PerfMonitor::EventLag, (perf->now() - posted) / 1e6);
+    }, Qt::QueuedConnection);
+    perf->tick();
+    if (perfHudCheck->isChecked()) chessboard->update();
+}
+
+void MainWindow::toggleWhatIf(bool enabled) {
+    if (enabled && startButton->text() == "停止") {
+        whatIfCheck->setChecked(false);
+        return;
+    }
+    // 摆放模式只在后台计数，棋盘可以比逐步演示更大；退出时超出的大小由 QSpinBox 收回到演示上限
+    sizeSpin->setMaximum(enabled ? MAX_WHAT_IF_SIZE : MAX_DEMO_SIZE);
+    chessboard->setEditable(enabled);
+    whatIfQueens.assign(boardSize, -1);
+    chessboard->setQueensManually(whatIfQueens);
+    if (enabled) {
+        restartWhatIf();
+    } else {
+        cancelWhatIf();
+        whatIfLabel->setText("");
+    }
+}
+
+void MainWindow::placeQueen(int row, int col) {
+    if (!whatIfCheck->isChecked()) return;
+    // 单击已有的皇后将其移除，否则把该行的皇后移到这一列
+    whatIfQueens[row] = whatIfQueens[row] == col ? -1 : col;
+    chessboard->setQueensManually(whatIfQueens);
+    restartWhatIf();
+}
+
+void MainWindow::restartWhatIf() {
+    cancelWhatIf();
+    int placed = int(std::count_if(whatIfQueens.begin(), whatIfQueens.end(), [](int c) { return c >= 0; }));
+    Core::NQueensCounter counter(boardSize, whatIfQueens);
+
+    Core::CacheEntry entry;
+    if (whatIfCache.lookup(counter.cacheKey(), {}, entry)) {
+        whatIfLabel->setText(QString("已放 %1 个皇后，完成数: %2 (缓存)").arg(placed).arg(qulonglong(entry.solutions)));
+        return;
+    }
+
+    if (serviceCheck->isChecked()) {
+        Core::QueryRequest request;
+        request.op = Core::QueryOp::Count;
+        request.n = boardSize;
+        if (placed > 0) request.fixed = whatIfQueens;
+        queryClient->setServerName(serviceEdit->text());
+        whatIfClock.start();
+        whatIfLabel->setText(QString("已放 %1 个皇后，查询服务计算中...").arg(placed));
+        whatIfRequest = queryClient->send(request);
+        return;
+    }
+
+    // 旧任务已在检查点退出，新任务复用其间已写入缓存的前缀小计
+    Core::SearchOptions options;
+    options.threads = std::max(1, QThread::idealThreadCount());
+    options.cache = &whatIfCache;
+    whatIfHandle.reset(new Core::SearchHandle(Core::searchAsync(counter, options)));
+    whatIfClock.start();
+    whatIfLabel->setText(QString("已放 %1 个皇后，计算完成数...").arg(placed));
+    whatIfTimer->start();
+}
+
+void MainWindow::cancelWhatIf() {
+    // 断开连接即撤回已发出的服务请求，服务端随之取消无人等待的计数，下一个请求不必排在它后面
+    if (whatIfRequest) queryClient->cancelAll();
+    whatIfRequest = 0;
+    whatIfTimer->stop();
+    if (!whatIfHandle) return;
+    whatIfHandle->cancel();
+    whatIfHandle->get();
+    whatIfHandle.reset();
+}
+
+void MainWindow::pollWhatIf() {
+    if (!whatIfHandle || !whatIfHandle->isReady()) return;
+    whatIfTimer->stop();
+    Core::SearchResult result = whatIfHandle->get();
+    whatIfHandle.reset();
+    int placed = int(std::count_if(whatIfQueens.begin(), whatIfQueens.end(), [](int c) { return c >= 0; }));
+    whatIfLabel->setText(QString("已放 %1 个皇后，完成数: %2 (%3 ms)")
+                             .arg(placed).arg(qulonglong(result.solutions)).arg(whatIfClock.elapsed()));
+}
+
+void MainWindow::handleQueryResponse(quint64 id, const Core::QueryResponse &response) {
+    if (id != whatIfRequest) return;
+    whatIfRequest = 0;
+    whatIfCache.store(Core::NQueensCounter(boardSize, whatIfQueens).cacheKey(), {}, {response.solutions, response.nodes});
+    int placed = int(std::count_if(whatIfQueens.begin(), whatIfQueens.end(), [](int c) { return c >= 0; }));
+    whatIfLabel->setText(QString("已放 %1 个皇后，完成数: %2 (查询服务 %3 ms)")
+                             .arg(placed).arg(qulonglong(response.solutions)).arg(whatIfClock.elapsed()));
+}
+
+void MainWindow::handleQueryFailure(quint64 id, const QString &message) {
+    if (id != whatIfRequest) return;
+    whatIfRequest = 0;
+    whatIfLabel->setText(QString("查询服务不可用: %1").arg(message));
+}
+
+StepMode MainWindow::stepMode() const {
+    return StepMode(stepModeCombo->currentData().toInt());
+}
+
+void MainWindow::startEstimate() {
+    // 启发式首解的步数取决于重启次数，无从预估
+    if (stepMode() == StepMode::FirstSolution) {
+        etaLabel->setText("");
+        return;
+    }
+    // 对第 0 行每一列的子树做随机探测，估计 NQueensSolver 的试探步数；逐位步进时每一步即一次放置
+    bool freeBits = stepMode() == StepMode::FreeBits;
+    Core::NQueensCounter counter(boardSize);
+    Core::TreeEstimator estimator(boardSize);
+    std::vector<double> unitSteps;
+    estimatedBaseSolutions = 0;
+    for (const Core::WorkUnit &unit : counter.split(1)) {
+        Core::TreeEstimate est = estimator.estimateUnit(unit, ESTIMATE_PROBES);
+        unitSteps.push_back(1.0 + (freeBits ? est.nodes : est.trials));
+        estimatedBaseSolutions += est.solutions;
+    }
+    runProgress.reset(unitSteps);
+    baseSolutionsFound = 0;
+    currentRootCol = -1;
+    rootStartSteps = 0;
+    lastSteps = 0;
+    updateEta();
+}
+
+void MainWindow::trackEstimate(const SolverState& state) {
+    if (stepMode() == StepMode::FirstSolution) return;
+    // 第 0 行换列说明上一列的子树已经搜索完毕，用实际步数替换估计值
+    bool rootMoved = state.trialPos.first == 0 && state.trialPos.second != currentRootCol;
+    if ((rootMoved || state.isFinished) && currentRootCol >= 0) {
+        int endSteps = state.isFinished ? state.stepsCount : state.stepsCount - 1;
+        runProgress.complete(currentRootCol, endSteps - rootStartSteps + 1);
+    }
+    if (rootMoved) {
+        currentRootCol = state.trialPos.second;
+        rootStartSteps = state.stepsCount;
+    }
+    if (state.solutionFound) baseSolutionsFound++;
+    lastSteps = state.stepsCount;
+}
+
+void MainWindow::updateEta() {
+    if (!solver || stepMode() == StepMode::FirstSolution) return;
+    double inCurrent = currentRootCol >= 0 ? lastSteps - rootStartSteps + 1 : 0;
+    double remainingSteps = std::max(0.0, runProgress.remaining() - inCurrent);
+    double remainingPauses = std::max(0.0, estimatedBaseSolutions - baseSolutionsFound);
+    double ms = remainingSteps * timer->interval() + remainingPauses * SOLUTION_PAUSE_MS;
+    int percent = int(100.0 * std::min(1.0, (runProgress.done() + inCurrent) / std::max(1.0, runProgress.total())));
+    etaLabel->setText(QString("预计剩余: %1 (%2%)").arg(formatDuration(ms)).arg(percent));
 }
 
 void MainWindow::handleSnapshot(const SolverState& state) {
@@ -179,6 +563,15 @@ void MainWindow::handleSnapshot(const SolverState& state) {
     int currentId = state.solutionsCount - state.newSolutionsFound + 1;
     saveSnapshot(currentId, false, state.queens); // 保存基础解
 
+    // 最后一行的皇后只记录在 trialPos 中，入库前补全
+    std::vector<int> solution = state.queens;
+    if (state.trialPos.first >= 0) solution[state.trialPos.first] = state.trialPos.second;
+    gallery->addSolution(solution);
+    if (state.isSymmetricBase) {
+        for (int &col : solution) col = (boardSize - 1) - col;
+        gallery->addSolution(solution);
+    }
+
     QString msg = QString("找到解 #%1").arg(currentId);
 
     if (state.isSymmetricBase) {
@@ -197,14 +590,16 @@ void MainWindow::handleSnapshot(const SolverState& state) {
     });
 }
 
-void MainWindow::saveSnapshot(int solutionIndex, bool isMirror, QVector<int> queens) {
+void MainWindow::saveSnapshot(int solutionIndex, bool isMirror, std::vector<int> queens) {
+    PerfScope scope(perf, PerfMonitor::SnapshotTime);
+    Core::TraceScope trace("snapshot", "ui", solutionIndex);
     QString appPath = QCoreApplication::applicationDirPath();
     QString imgDirPath = appPath + "/img";
     QDir imgDir(imgDirPath);
     if (!imgDir.exists()) imgDir.mkpath(".");
 
     if (isMirror) {
-        QVector<int> mirrorQueens = queens;
+        std::vector<int> mirrorQueens = queens;
         for(int& col : mirrorQueens) {
             if (col != -1) col = (boardSize - 1) - col;
         }
@@ -212,9 +607,16 @@ void MainWindow::saveSnapshot(int solutionIndex, bool isMirror, QVector<int> que
         chessboard->repaint(); // 强制重绘以供 grab() 抓取
     }
 
-    QPixmap pixmap = chessboard->grab();
+    QPixmap pixmap;
+    {
+        Core::TraceScope grab("grab", "ui");
+        pixmap = chessboard->grab();
+    }
     QString fileName = QString("%1/solution_%2.png").arg(imgDirPath).arg(solutionIndex);
-    pixmap.save(fileName, "PNG");
+    {
+        Core::TraceScope encode("encode-png", "ui");
+        pixmap.save(fileName, "PNG");
+    }
 
     if (isMirror) {
         chessboard->setQueensManually(queens); // 恢复原状
@@ -4,10 +4,20 @@
 #include <QLabel>
 #include <QSpinBox>
 #include <QComboBox>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QElapsedTimer>
+#include <memory>
 #include <QTimer>
 
+#include "core/AsyncSolver.h"
 #include "core/NQueensSolver.h"
+#include "core/ResultCache.h"
+#include "core/TreeEstimator.h"
 #include "ui/ChessboardWidget.h"
+#include "ui/QueryClient.h"
+#include "ui/SolutionGallery.h"
+#include "ui/WorkerBoardsPanel.h"
 
 namespace NQueens {
     namespace UI {
@@ -25,6 +35,17 @@ namespace NQueens {
             void toggleSearch();
             void togglePause();
             void nextStep();
+            void showGallerySolution(int size, const std::vector<int> &queens);
+            void toggleHeatmap(bool visible);
+            void updatePerfMonitoring();
+            void togglePerfLog(bool enabled);
+            void toggleTrace(bool enabled);
+            void perfTick();
+            void toggleWhatIf(bool enabled);
+            void placeQueen(int row, int col);
+            void pollWhatIf();
+            void handleQueryResponse(quint64 id, const Core::QueryResponse &response);
+            void handleQueryFailure(quint64 id, const QString &message);
 
         private:
             void setupUI();
@@ -32,22 +53,72 @@ namespace NQueens {
             void resetSearch();
             void resetUIState(bool finished);
 
+            // 剩余时间估计
+            StepMode stepMode() const;
+            void startEstimate();
+            void trackEstimate(const SolverState& state);
+            void updateEta();
+
+            // 在后台统计当前 N 的逐格占用次数并显示为热力图
+            void loadHeatmap();
+
+            // 摆放模式：取消上一次计数，对当前布局重新统计完成数
+            void restartWhatIf();
+            void cancelWhatIf();
+
             // 截图辅助函数
             void handleSnapshot(const SolverState& state);
-            void saveSnapshot(int solutionIndex, bool isMirror, QVector<int> queens);
+            void saveSnapshot(int solutionIndex, bool isMirror, std::vector<int> queens);
 
             int boardSize;
             Core::NQueensSolver *solver;
             ChessboardWidget *chessboard;
+            SolutionGallery *gallery;
             QTimer *timer;
             bool isPaused;
 
+            Core::RunProgress runProgress;  // 以第 0 行各列的子树为单元，单位为步数
+            double estimatedBaseSolutions;
+            int baseSolutionsFound;
+            int currentRootCol;
+            int rootStartSteps;
+            int lastSteps;
+
             QSpinBox *sizeSpin;
             QComboBox *speedCombo;
             QPushButton *startButton;
             QPushButton *pauseButton;
             QLabel *statusLabel;
             QLabel *statsLabel;
+            QLabel *etaLabel;
+            QCheckBox *heatmapCheck;
+            int heatmapRequest;
+
+            // 步进方式：逐列试探、逐位步进（可选显示被跳过的受攻击格子）或启发式首解
+            QComboBox *stepModeCombo;
+            QCheckBox *skippedCheck;
+
+            // 性能 HUD 与 CSV 日志都关闭时为空，各计量点不做任何计时
+            PerfMonitor *perf;
+            QTimer *perfTimer;
+            QCheckBox *perfHudCheck;
+            QCheckBox *perfLogCheck;
+            QCheckBox *traceCheck;  // 记录时间线，取消勾选时导出为 Chrome trace JSON
+
+            // 摆放模式（what-if）
+            QCheckBox *whatIfCheck;
+            QLabel *whatIfLabel;
+            QTimer *whatIfTimer;
+            std::vector<int> whatIfQueens;
+            std::unique_ptr<Core::SearchHandle> whatIfHandle;
+            Core::ResultCache whatIfCache;  // 仅在内存中，撤销回到之前的布局时直接命中
+            QElapsedTimer whatIfClock;
+
+            // 勾选后摆放模式的完成数改由常驻查询服务计算
+            QCheckBox *serviceCheck;
+            QLineEdit *serviceEdit;
+            QueryClient *queryClient;
+            quint64 whatIfRequest;
         };
 
     } // namespace UI
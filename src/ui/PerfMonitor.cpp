@@ -0,0 +1,156 @@
+#include "PerfMonitor.h"
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+namespace NQueens {
+namespace UI {
+
+namespace {
+
+const int BUCKETS_PER_OCTAVE = 3;
+
+const char *METRIC_NAMES[PerfMonitor::METRIC_COUNT] = {
+    "frame_interval", "paint", "step_interval", "step", "event_lag", "snapshot"
+};
+
+// 桶 b 覆盖 [2^(b/3), 2^((b+1)/3)) 微秒
+double bucketUpperMs(int bucket) {
+    return std::pow(2.0, double(bucket + 1) / BUCKETS_PER_OCTAVE) / 1000.0;
+}
+
+} // namespace
+
+int RollingHistogram::bucketOf(double ms) {
+    double us = std::max(1.0, ms * 1000.0);
+    return std::min(BUCKETS - 1, int(std::log2(us) * BUCKETS_PER_OCTAVE));
+}
+
+void RollingHistogram::add(double ms) {
+    if (filled == WINDOW) {
+        counts[sampleBuckets[head]]--;
+        sum -= samples[head];
+    } else {
+        filled++;
+    }
+    int bucket = bucketOf(ms);
+    counts[bucket]++;
+    samples[head] = ms;
+    sampleBuckets[head] = (uint8_t)bucket;
+    sum += ms;
+    head = (head + 1) % WINDOW;
+}
+
+double RollingHistogram::percentile(double p) const {
+    if (!filled) return 0.0;
+    uint32_t target = uint32_t(std::ceil(p * filled));
+    uint32_t seen = 0;
+    for (int b = 0; b < BUCKETS; ++b) {
+        seen += counts[b];
+        if (seen >= std::max(1u, target)) return bucketUpperMs(b);
+    }
+    return bucketUpperMs(BUCKETS - 1);
+}
+
+PerfMonitor::PerfMonitor() : lastFrame(-1), lastStep(-1), lastLogRow(0), timerInterval(0), lastPaintCells(0) {
+    clock.start();
+}
+
+PerfMonitor::~PerfMonitor() {
+    stopLog();
+}
+
+void PerfMonitor::record(Metric metric, double ms) {
+    histograms[metric].add(ms);
+}
+
+void PerfMonitor::markFrame() {
+    qint64 t = now();
+    if (lastFrame >= 0) record(FrameInterval, (t - lastFrame) / 1e6);
+    lastFrame = t;
+}
+
+void PerfMonitor::markStep() {
+    qint64 t = now();
+    if (lastStep >= 0) record(StepInterval, (t - lastStep) / 1e6);
+    lastStep = t;
+}
+
+void PerfMonitor::startPaintCounters() {
+    if (paintCounters.available()) paintCounters.start();
+}
+
+void PerfMonitor::stopPaintCounters(int cells) {
+    if (!paintCounters.available()) return;
+    lastPaint = paintCounters.stop();
+    lastPaintCells = cells;
+}
+
+QStringList PerfMonitor::summary() const {
+    auto rate = [](const RollingHistogram &h) { return h.count() ? 1000.0 / std::max(1e-3, h.mean()) : 0.0; };
+    const RollingHistogram &frames = histograms[FrameInterval];
+    const RollingHistogram &paint = histograms[PaintTime];
+    const RollingHistogram &steps = histograms[StepInterval];
+    const RollingHistogram &step = histograms[StepTime];
+    const RollingHistogram &lag = histograms[EventLag];
+    const RollingHistogram &snapshot = histograms[SnapshotTime];
+
+    QStringList lines;
+    lines << QString("帧率 %1/s").arg(rate(frames), 0, 'f', 1);
+    lines << QString("绘制 %1 ms (p99 %2)").arg(paint.last(), 0, 'f', 2).arg(paint.percentile(0.99), 0, 'f', 2);
+    lines << QString("步进 %1/s (设定间隔 %2 ms)").arg(rate(steps), 0, 'f', 1).arg(timerInterval);
+    lines << QString("求解 %1 ms (p99 %2)").arg(step.mean(), 0, 'f', 3).arg(step.percentile(0.99), 0, 'f', 3);
+    lines << QString("事件队列延迟 %1 ms (p99 %2)").arg(lag.percentile(0.5), 0, 'f', 2).arg(lag.percentile(0.99), 0, 'f', 2);
+    lines << QString("截图 %1 ms (p99 %2)").arg(snapshot.last(), 0, 'f', 1).arg(snapshot.percentile(0.99), 0, 'f', 1);
+
+    // 上一帧绘制的计数器读数，未命中数按棋盘格数平均
+    if (!paintCounters.available()) {
+        lines << QString("硬件计数器不可用");
+    } else if (lastPaintCells > 0) {
+        auto perCell = [&](Core::PerfEvent e) {
+            double v = lastPaint.per(e, lastPaintCells);
+            return v < 0 ? QString("-") : QString::number(v, 'f', 1);
+        };
+        lines << QString("绘制 IPC %1，每格未命中 分支 %2 / L1d %3 / LLC %4")
+                     .arg(lastPaint.ipc(), 0, 'f', 2)
+                     .arg(perCell(Core::PerfEvent::BranchMisses))
+                     .arg(perCell(Core::PerfEvent::L1dMisses))
+                     .arg(perCell(Core::PerfEvent::LlcMisses));
+    }
+    return lines;
+}
+
+bool PerfMonitor::startLog(const QString &path) {
+    stopLog();
+    log.setFileName(path);
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
+    QTextStream out(&log);
+    out << "time_s,timer_interval_ms";
+    for (const char *name : METRIC_NAMES) out << ',' << name << "_count," << name << "_mean_ms," << name << "_p50_ms," << name << "_p99_ms";
+    out << '\n';
+    lastLogRow = now();
+    return true;
+}
+
+void PerfMonitor::stopLog() {
+    if (log.isOpen()) log.close();
+}
+
+void PerfMonitor::tick() {
+    if (!log.isOpen()) return;
+    qint64 t = now();
+    if (t - lastLogRow < 1000000000LL) return;
+    lastLogRow = t;
+
+    QTextStream out(&log);
+    out << QString::number(t / 1e9, 'f', 3) << ',' << timerInterval;
+    for (const RollingHistogram &h : histograms) {
+        out << ',' << h.count() << ',' << QString::number(h.mean(), 'f', 4) << ','
+            << QString::number(h.percentile(0.5), 'f', 4) << ',' << QString::number(h.percentile(0.99), 'f', 4);
+    }
+    out << '\n';
+    out.flush();
+}
+
+} // namespace UI
+} // namespace NQueens
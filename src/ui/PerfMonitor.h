@@ -0,0 +1,97 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <cstdint>
+
+#include "core/PerfCounters.h"
+
+namespace NQueens {
+	namespace UI {
+
+		// 滑动窗口直方图：保留最近 WINDOW 个样本，按对数分桶（每倍频 3 桶，1 微秒到约 2 秒），
+		// 新样本进入时淘汰最旧的样本，分位数直接扫描桶计数得到
+		class RollingHistogram {
+		public:
+			static const int BUCKETS = 64;
+			static const int WINDOW = 512;
+
+			void add(double ms);
+			double percentile(double p) const;
+			double mean() const { return filled ? sum / filled : 0.0; }
+			double last() const { return filled ? samples[(head + WINDOW - 1) % WINDOW] : 0.0; }
+			int count() const { return filled; }
+
+		private:
+			static int bucketOf(double ms);
+
+			std::array<uint32_t, BUCKETS> counts{};
+			std::array<double, WINDOW> samples{};
+			std::array<uint8_t, WINDOW> sampleBuckets{};
+			int head = 0;
+			int filled = 0;
+			double sum = 0.0;
+		};
+
+		// 可视化器的性能计量：帧间隔、绘制耗时、求解步进、事件循环延迟与截图耗时。
+		// 关闭时各调用点持有空指针，只剩一次判断。
+		class PerfMonitor {
+		public:
+			enum Metric { FrameInterval, PaintTime, StepInterval, StepTime, EventLag, SnapshotTime, METRIC_COUNT };
+
+			PerfMonitor();
+			~PerfMonitor();
+
+			qint64 now() const { return clock.nsecsElapsed(); }
+			void record(Metric metric, double ms);
+
+			// 分别在每次 paintEvent / nextStep 开始时调用，记录与上一次的间隔
+			void markFrame();
+			void markStep();
+			void setTimerInterval(int ms) { timerInterval = ms; }
+
+			// 绘制区间的硬件计数器（Linux perf_event_open），不可用时两者都不做任何事
+			void startPaintCounters();
+			void stopPaintCounters(int cells);
+
+			const RollingHistogram &histogram(Metric metric) const { return histograms[metric]; }
+			QStringList summary() const;
+
+			// CSV 日志：每秒一行，包含各项指标的均值与 p50/p99
+			bool startLog(const QString &path);
+			void stopLog();
+			bool isLogging() const { return log.isOpen(); }
+			void tick();
+
+		private:
+			QElapsedTimer clock;
+			std::array<RollingHistogram, METRIC_COUNT> histograms;
+			qint64 lastFrame;
+			qint64 lastStep;
+			qint64 lastLogRow;
+			int timerInterval;
+			QFile log;
+			Core::PerfCounters paintCounters;
+			Core::PerfSample lastPaint;
+			int lastPaintCells;
+		};
+
+		// 作用域计时：monitor 为空时不读时钟
+		class PerfScope {
+		public:
+			PerfScope(PerfMonitor *monitor, PerfMonitor::Metric metric)
+				: monitor(monitor), metric(metric), start(monitor ? monitor->now() : 0) {}
+			~PerfScope() {
+				if (monitor) monitor->record(metric, (monitor->now() - start) / 1e6);
+			}
+
+		private:
+			PerfMonitor *monitor;
+			PerfMonitor::Metric metric;
+			qint64 start;
+		};
+
+	} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,117 @@
+#include "QueryClient.h"
+#include <exception>
+
+namespace NQueens {
+namespace UI {
+
+QueryClient::QueryClient(QObject *parent) : QObject(parent), socket(new QLocalSocket(this)), nextId(1) {
+    connect(socket, &QLocalSocket::connected, this, &QueryClient::writeQueued);
+    connect(socket, &QLocalSocket::readyRead, this, &QueryClient::readResponses);
+    connect(socket, &QLocalSocket::errorOccurred, this, &QueryClient::handleError);
+    connect(socket, &QLocalSocket::disconnected, this, &QueryClient::handleDisconnect);
+}
+
+void QueryClient::setServerName(const QString &path) {
+    if (path == server) return;
+    server = path;
+    if (socket->state() != QLocalSocket::UnconnectedState) {
+        socket->abort();
+        failAll("已切换查询服务");
+    }
+}
+
+quint64 QueryClient::send(const Core::QueryRequest &request) {
+    quint64 id = nextId++;
+    std::string frame;
+    try {
+        frame = Core::queryFrame(Core::encodeRequest(request));
+    } catch (const std::exception &e) {
+        failLater(id, QString::fromUtf8(e.what()));
+        return id;
+    }
+
+    pending.push_back({id, request, QByteArray(frame.data(), qsizetype(frame.size()))});
+    switch (socket->state()) {
+    case QLocalSocket::ConnectedState:
+        writeQueued();
+        break;
+    case QLocalSocket::UnconnectedState:
+        // 连接结果由 connected / errorOccurred 信号送达
+        buffer.clear();
+        socket->connectToServer(server);
+        break;
+    default:
+        break;  // 正在连接，连上后统一写出
+    }
+    return id;
+}
+
+void QueryClient::cancelAll() {
+    // 先清空再断开，断开信号不会让被放弃的请求以 failed 结束
+    pending.clear();
+    buffer.clear();
+    if (socket->state() != QLocalSocket::UnconnectedState) socket->abort();
+}
+
+void QueryClient::writeQueued() {
+    for (Pending &p : pending) {
+        if (p.frame.isEmpty()) continue;
+        socket->write(p.frame);
+        p.frame.clear();
+    }
+}
+
+void QueryClient::handleError() {
+    // 已连接后的错误随后会有 disconnected；这里只处理连接失败（服务未启动、套接字不存在等）。
+    // 套接字不存在时错误在 connectToServer 内同步发出，失败信号排队发出，保证晚于 send 返回
+    if (socket->state() == QLocalSocket::ConnectedState) return;
+    QString reason = socket->errorString();
+    if (socket->state() != QLocalSocket::UnconnectedState) socket->abort();
+    buffer.clear();
+    std::deque<Pending> lost;
+    lost.swap(pending);
+    for (const Pending &p : lost) failLater(p.id, reason);
+}
+
+void QueryClient::readResponses() {
+    buffer.append(socket->readAll());
+    for (;;) {
+        if (buffer.size() < qsizetype(Core::QUERY_FRAME_HEADER)) return;
+        quint32 length = Core::queryFrameLength(buffer.constData());
+        if (buffer.size() < qsizetype(Core::QUERY_FRAME_HEADER + length)) return;
+        std::string payload(buffer.constData() + Core::QUERY_FRAME_HEADER, length);
+        buffer.remove(0, qsizetype(Core::QUERY_FRAME_HEADER + length));
+
+        if (pending.empty()) continue;
+        Pending done = pending.front();
+        pending.pop_front();
+        try {
+            Core::QueryResponse response = Core::decodeResponse(done.request, payload);
+            if (response.ok)
+                emit responseReady(done.id, response);
+            else
+                emit failed(done.id, QString::fromStdString(response.error));
+        } catch (const std::exception &e) {
+            emit failed(done.id, QString::fromUtf8(e.what()));
+        }
+    }
+}
+
+void QueryClient::handleDisconnect() {
+    buffer.clear();
+    failAll("查询服务已断开");
+}
+
+void QueryClient::failLater(quint64 id, const QString &message) {
+    // 排队发出，调用方先拿到编号再收到失败
+    QMetaObject::invokeMethod(this, [this, id, message]() { emit failed(id, message); }, Qt::QueuedConnection);
+}
+
+void QueryClient::failAll(const QString &message) {
+    std::deque<Pending> lost;
+    lost.swap(pending);
+    for (const Pending &p : lost) emit failed(p.id, message);
+}
+
+} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,60 @@
+#pragma once
+#include <QObject>
+#include <QByteArray>
+#include <QLocalSocket>
+#include <QString>
+#include <deque>
+
+#include "core/QueryProtocol.h"
+
+namespace NQueens {
+	namespace UI {
+
+		// 查询服务（nqueens-cli serve）的客户端：复用一个本地套接字连接，请求按发送顺序应答。
+		// 首次发送时异步连接，连接建立前的请求排队，连上后依次写出；连接失败或断开后所有未应答的请求以 failed 结束，
+		// 下次发送时重连。任何调用都不会阻塞界面线程。
+		class QueryClient : public QObject {
+			Q_OBJECT
+
+		public:
+			explicit QueryClient(QObject *parent = nullptr);
+
+			void setServerName(const QString &path);
+			QString serverName() const { return server; }
+
+			// 返回请求编号，应答或失败信号带回同一编号；失败信号总在 send 返回之后发出
+			quint64 send(const Core::QueryRequest &request);
+
+			// 放弃所有未应答的请求（不再发出信号）并断开连接；服务端发现断开后取消无人等待的计算。
+			// 下次 send 时重新连接，新请求不必排在旧请求之后
+			void cancelAll();
+
+		signals:
+			void responseReady(quint64 id, const Core::QueryResponse &response);
+			void failed(quint64 id, const QString &message);
+
+		private slots:
+			void readResponses();
+			void writeQueued();
+			void handleError();
+			void handleDisconnect();
+
+		private:
+			struct Pending {
+				quint64 id;
+				Core::QueryRequest request;
+				QByteArray frame;   // 尚未写出时非空
+			};
+
+			void failLater(quint64 id, const QString &message);
+			void failAll(const QString &message);
+
+			QLocalSocket *socket;
+			QString server;
+			QByteArray buffer;
+			std::deque<Pending> pending;
+			quint64 nextId;
+		};
+
+	} // namespace UI
+} // namespace NQueens
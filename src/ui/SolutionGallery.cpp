@@ -0,0 +1,157 @@
+#include "SolutionGallery.h"
+#include "core/SolutionStream.h"
+#include <QCoreApplication>
+#include <QPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVBoxLayout>
+
+namespace NQueens {
+namespace UI {
+
+SolutionGallery::SolutionGallery(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(8, 8, 8, 8);
+
+    summaryLabel = new QLabel("暂无解");
+    loadButton = new QPushButton("载入全部解");
+    connect(loadButton, &QPushButton::clicked, this, &SolutionGallery::loadAllRequested);
+
+    filterEdit = new QLineEdit;
+    filterEdit->setPlaceholderText("载入全部解后可按格筛选，如 0:3,5:1");
+    filterEdit->setClearButtonEnabled(true);
+    filterEdit->setEnabled(false);
+    connect(filterEdit, &QLineEdit::textChanged, this, &SolutionGallery::applyFilter);
+
+    model = new SolutionGalleryModel(this);
+    view = new QListView;
+    view->setModel(model);
+    // 静态布局 + 统一尺寸 + 分批布局：只为可见项取数据，几十万项也不会卡顿
+    view->setViewMode(QListView::IconMode);
+    view->setMovement(QListView::Static);
+    view->setResizeMode(QListView::Adjust);
+    view->setUniformItemSizes(true);
+    view->setLayoutMode(QListView::Batched);
+    view->setBatchSize(1000);
+    view->setIconSize(QSize(SolutionGalleryModel::THUMBNAIL_SIZE, SolutionGalleryModel::THUMBNAIL_SIZE));
+    view->setGridSize(QSize(SolutionGalleryModel::THUMBNAIL_SIZE + 16, SolutionGalleryModel::THUMBNAIL_SIZE + 28));
+    view->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(view, &QListView::clicked, this, [this](const QModelIndex &index) {
+        emit solutionActivated(model->boardSize(), model->solution(index.row()));
+    });
+
+    layout->addWidget(summaryLabel);
+    layout->addWidget(loadButton);
+    layout->addWidget(filterEdit);
+    layout->addWidget(view, 1);
+    setMinimumWidth(SolutionGalleryModel::THUMBNAIL_SIZE * 2 + 60);
+}
+
+SolutionGallery::~SolutionGallery() {
+    cancelLoading();
+}
+
+void SolutionGallery::reset(int boardSize) {
+    cancelLoading();
+    dropIndex();
+    model->reset(boardSize);
+    updateSummary();
+}
+
+void SolutionGallery::addSolution(const std::vector<int> &queens) {
+    // 索引只覆盖载入时的解集合
+    if (index) dropIndex();
+    model->append(queens);
+    updateSummary();
+}
+
+void SolutionGallery::loadAll(int boardSize) {
+    cancelLoading();
+    dropIndex();
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    loadCancelled = cancelled;
+    loadButton->setEnabled(false);
+    summaryLabel->setText(QString("正在生成 N=%1 的全部解...").arg(boardSize));
+
+    // 结果回到界面线程后再检查面板是否还存在
+    QPointer<SolutionGallery> self(this);
+    QThreadPool::globalInstance()->start([self, boardSize, cancelled]() {
+        auto packed = std::make_shared<Core::PackedSolutions>(boardSize);
+        for (const auto &queens : Core::solutionStream(boardSize)) {
+            if (cancelled->load(std::memory_order_relaxed)) return;
+            packed->append(queens);
+        }
+        // 解编号即 solutionStream 中的位置，与模型的行号一致
+        std::shared_ptr<const Core::SolutionBitmapIndex> built = std::make_shared<Core::SolutionBitmapIndex>(*packed);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, packed, built, cancelled]() {
+            if (!self || cancelled->load()) return;
+            self->model->setSolutions(std::move(*packed));
+            self->index = built;
+            self->loadButton->setEnabled(true);
+            self->filterEdit->setEnabled(true);
+            self->applyFilter();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SolutionGallery::cancelLoading() {
+    if (loadCancelled) loadCancelled->store(true);
+    loadCancelled.reset();
+    loadButton->setEnabled(true);
+}
+
+void SolutionGallery::applyFilter() {
+    filterError.clear();
+    QString text = filterEdit->text().trimmed();
+    if (!index || text.isEmpty()) {
+        model->clearFilter();
+        updateSummary();
+        return;
+    }
+
+    int n = index->boardSize();
+    std::vector<int> fixed(n, -1);
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts)) {
+        QStringList parts = item.split(':');
+        bool rowOk = false, colOk = false;
+        int row = parts.size() == 2 ? parts[0].trimmed().toInt(&rowOk) : -1;
+        int col = parts.size() == 2 ? parts[1].trimmed().toInt(&colOk) : -1;
+        if (!rowOk || !colOk || row < 0 || row >= n || col < 0 || col >= n) {
+            // 输入到一半时保留上一次的结果
+            filterError = QString("筛选条件应为 行:列,...，且不超出棋盘: %1").arg(item.trimmed());
+            updateSummary();
+            return;
+        }
+        fixed[row] = col;
+    }
+    model->setFilter(index->query(fixed).values());
+    updateSummary();
+}
+
+void SolutionGallery::dropIndex() {
+    index.reset();
+    filterEdit->blockSignals(true);
+    filterEdit->clear();
+    filterEdit->blockSignals(false);
+    filterEdit->setEnabled(false);
+    model->clearFilter();
+}
+
+void SolutionGallery::updateSummary() {
+    int count = model->totalCount();
+    if (count == 0) {
+        summaryLabel->setText("暂无解");
+        return;
+    }
+    QString text = QString("N=%1 共 %2 个解（占用 %3 KB）")
+                       .arg(model->boardSize()).arg(count).arg(qulonglong(model->packedBytes() / 1024));
+    if (!filterError.isEmpty()) {
+        text += "\n" + filterError;
+    } else if (model->isFiltered()) {
+        text += QString("\n筛选出 %1 个（位图索引 %2 KB）").arg(model->rowCount()).arg(qulonglong(index->bytes() / 1024));
+    }
+    summaryLabel->setText(text);
+}
+
+} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,53 @@
+#pragma once
+#include <QWidget>
+#include <QListView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/SolutionBitmapIndex.h"
+#include "ui/SolutionGalleryModel.h"
+
+namespace NQueens {
+	namespace UI {
+
+		// 解库面板：虚拟化的缩略图网格，单击缩略图把该解载入主棋盘。
+		// 载入全部解后同时建逐格位图索引，可按 "行:列,..." 筛选在这些格子上都有皇后的解
+		class SolutionGallery : public QWidget {
+			Q_OBJECT
+
+		public:
+			explicit SolutionGallery(QWidget *parent = nullptr);
+			~SolutionGallery() override;
+
+			void reset(int boardSize);
+			void addSolution(const std::vector<int> &queens);
+
+			// 在后台线程按求解顺序生成 N 的全部解与位图索引，并替换当前内容
+			void loadAll(int boardSize);
+
+		signals:
+			void loadAllRequested();
+			void solutionActivated(int boardSize, const std::vector<int> &queens);
+
+		private:
+			void cancelLoading();
+			void applyFilter();
+			void dropIndex();
+			void updateSummary();
+
+			SolutionGalleryModel *model;
+			QListView *view;
+			QLabel *summaryLabel;
+			QPushButton *loadButton;
+			QLineEdit *filterEdit;
+			std::shared_ptr<const Core::SolutionBitmapIndex> index;
+			QString filterError;
+			std::shared_ptr<std::atomic<bool>> loadCancelled;
+		};
+
+	} // namespace UI
+} // namespace NQueens
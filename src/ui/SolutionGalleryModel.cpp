@@ -0,0 +1,160 @@
+#include "SolutionGalleryModel.h"
+#include "common/Config.h"
+#include <QPainter>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+namespace NQueens {
+namespace UI {
+
+using namespace NQueens::Config;
+
+namespace {
+
+// 缩略图缓存上限（KB），约 2800 张 96px 缩略图
+const int THUMBNAIL_CACHE_KB = 100 * 1024;
+
+} // namespace
+
+SolutionGalleryModel::SolutionGalleryModel(QObject *parent)
+    : QAbstractListModel(parent), filtered(false), generation(0), requestPriority(0), thumbnails(THUMBNAIL_CACHE_KB) {
+    pool = new QThreadPool(this);
+    pool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+
+    placeholder = QPixmap(THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+    placeholder.fill(Colors::DarkSquare);
+}
+
+SolutionGalleryModel::~SolutionGalleryModel() {
+    pool->clear();
+    pool->waitForDone();
+}
+
+void SolutionGalleryModel::reset(int boardSize) {
+    setSolutions(Core::PackedSolutions(boardSize));
+}
+
+void SolutionGalleryModel::setSolutions(Core::PackedSolutions packed) {
+    beginResetModel();
+    discardThumbnails();
+    solutions = std::move(packed);
+    filter.clear();
+    filtered = false;
+    endResetModel();
+}
+
+void SolutionGalleryModel::append(const std::vector<int> &queens) {
+    if (filtered) clearFilter();
+    int row = (int)solutions.size();
+    beginInsertRows(QModelIndex(), row, row);
+    solutions.append(queens);
+    endInsertRows();
+}
+
+void SolutionGalleryModel::setFilter(std::vector<uint32_t> ids) {
+    // 行号含义改变，已有缩略图全部作废
+    beginResetModel();
+    discardThumbnails();
+    filter = std::move(ids);
+    filtered = true;
+    endResetModel();
+}
+
+void SolutionGalleryModel::clearFilter() {
+    if (!filtered) return;
+    beginResetModel();
+    discardThumbnails();
+    filter.clear();
+    filtered = false;
+    endResetModel();
+}
+
+int SolutionGalleryModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return filtered ? (int)filter.size() : (int)solutions.size();
+}
+
+QVariant SolutionGalleryModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    int row = index.row();
+    int id = solutionId(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("#%1").arg(id + 1);
+    case Qt::DecorationRole:
+        if (QPixmap *cached = thumbnails.object(row)) return *cached;
+        requestThumbnail(row);
+        return placeholder;
+    case Qt::ToolTipRole: {
+        QStringList cols;
+        for (int c : solutions.at(id)) cols << QString::number(c);
+        return QString("解 #%1: %2").arg(id + 1).arg(cols.join(' '));
+    }
+    default:
+        return QVariant();
+    }
+}
+
+void SolutionGalleryModel::requestThumbnail(int row) const {
+    if (pending.contains(row)) return;
+    pending.insert(row);
+
+    // 后请求的优先绘制：快速滚动时，当前可见的项先于已经滚出视野的项完成
+    std::vector<int> queens = solution(row);
+    quint64 requestGeneration = generation;
+    SolutionGalleryModel *self = const_cast<SolutionGalleryModel *>(this);
+    pool->start([self, requestGeneration, row, queens]() {
+        QImage image = renderThumbnail(queens, THUMBNAIL_SIZE);
+        QMetaObject::invokeMethod(self, [self, requestGeneration, row, image]() {
+            self->thumbnailReady(requestGeneration, row, image);
+        }, Qt::QueuedConnection);
+    }, ++requestPriority);
+}
+
+void SolutionGalleryModel::thumbnailReady(quint64 requestGeneration, int row, const QImage &image) {
+    if (requestGeneration != generation) return;
+    pending.remove(row);
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+    int costKb = std::max(1, int(image.sizeInBytes() / 1024));
+    thumbnails.insert(row, pixmap, costKb);
+    QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, {Qt::DecorationRole});
+}
+
+void SolutionGalleryModel::discardThumbnails() {
+    // 旧的绘制任务仍可能在运行，用代数区分后直接丢弃其结果
+    pool->clear();
+    ++generation;
+    requestPriority = 0;
+    pending.clear();
+    thumbnails.clear();
+}
+
+QImage SolutionGalleryModel::renderThumbnail(const std::vector<int> &queens, int size) {
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Colors::BoardBg);
+    int n = (int)queens.size();
+    if (n == 0) return image;
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    qreal cell = qreal(size) / n;
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            QColor color = ((r + c) % 2 == 0) ? Colors::LightSquare : Colors::DarkSquare;
+            painter.fillRect(QRectF(c * cell, r * cell, cell, cell), color);
+        }
+    }
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Colors::QueenSafe);
+    for (int r = 0; r < n; ++r) {
+        if (queens[r] < 0) continue;
+        painter.drawEllipse(QPointF(queens[r] * cell + cell / 2, r * cell + cell / 2), cell / 2.4, cell / 2.4);
+    }
+    return image;
+}
+
+} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,64 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+#include <QThreadPool>
+#include <vector>
+
+#include "core/PackedSolutions.h"
+
+namespace NQueens {
+	namespace UI {
+
+		// 解库模型：解存放在紧凑缓冲区中，只有视图实际请求的项才会生成缩略图。
+		// 缩略图由后台线程池绘制成 QImage，回到界面线程后放入有上限的 LRU 缓存。
+		// 设置筛选后只显示给定编号的解，行号与解编号不再相同。
+		class SolutionGalleryModel : public QAbstractListModel {
+			Q_OBJECT
+
+		public:
+			static const int THUMBNAIL_SIZE = 96;
+
+			explicit SolutionGalleryModel(QObject *parent = nullptr);
+			~SolutionGalleryModel() override;
+
+			void reset(int boardSize);
+			void setSolutions(Core::PackedSolutions packed);
+			void append(const std::vector<int> &queens);
+
+			// ids 为递增的解编号
+			void setFilter(std::vector<uint32_t> ids);
+			void clearFilter();
+			bool isFiltered() const { return filtered; }
+
+			int boardSize() const { return solutions.boardSize(); }
+			int totalCount() const { return (int)solutions.size(); }
+			int solutionId(int row) const { return filtered ? (int)filter[row] : row; }
+			std::vector<int> solution(int row) const { return solutions.at(solutionId(row)); }
+			size_t packedBytes() const { return solutions.bytes(); }
+
+			int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+			QVariant data(const QModelIndex &index, int role) const override;
+
+			static QImage renderThumbnail(const std::vector<int> &queens, int size);
+
+		private:
+			void requestThumbnail(int row) const;
+			void thumbnailReady(quint64 requestGeneration, int row, const QImage &image);
+			void discardThumbnails();
+
+			Core::PackedSolutions solutions;
+			std::vector<uint32_t> filter;
+			bool filtered;
+			quint64 generation;
+			mutable int requestPriority;
+			mutable QCache<int, QPixmap> thumbnails;  // 代价单位为 KB
+			mutable QSet<int> pending;
+			QThreadPool *pool;
+			QPixmap placeholder;
+		};
+
+	} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,154 @@
+#include "WorkerBoardsPanel.h"
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QScrollArea>
+#include <QThread>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+namespace NQueens {
+namespace UI {
+
+namespace {
+
+// 约 30 帧/秒采样
+const int SAMPLE_INTERVAL_MS = 33;
+const int MINI_BOARD_SIZE = 150;
+
+} // namespace
+
+WorkerBoardsPanel::WorkerBoardsPanel(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(8, 8, 8, 8);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(new QLabel("N:"));
+    sizeSpin = new QSpinBox;
+    sizeSpin->setRange(8, 20);
+    sizeSpin->setValue(16);
+    controls->addWidget(sizeSpin);
+    controls->addWidget(new QLabel("线程:"));
+    threadSpin = new QSpinBox;
+    threadSpin->setRange(1, 64);
+    threadSpin->setValue(std::max(1, QThread::idealThreadCount()));
+    controls->addWidget(threadSpin);
+    runButton = new QPushButton("并行计数");
+    connect(runButton, &QPushButton::clicked, this, &WorkerBoardsPanel::toggleRun);
+    controls->addWidget(runButton);
+    layout->addLayout(controls);
+
+    summaryLabel = new QLabel("各工作线程的当前部分棋盘与计数");
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    boardsArea = new QWidget;
+    new QGridLayout(boardsArea);
+    QScrollArea *scroll = new QScrollArea;
+    scroll->setWidgetResizable(true);
+    scroll->setWidget(boardsArea);
+    layout->addWidget(scroll, 1);
+
+    sampleTimer = new QTimer(this);
+    sampleTimer->setInterval(SAMPLE_INTERVAL_MS);
+    connect(sampleTimer, &QTimer::timeout, this, &WorkerBoardsPanel::sampleWorkers);
+}
+
+WorkerBoardsPanel::~WorkerBoardsPanel() {
+    // 后台搜索引用着 monitor，必须等它结束
+    if (handle) {
+        handle->cancel();
+        handle->get();
+    }
+}
+
+void WorkerBoardsPanel::toggleRun() {
+    if (handle) {
+        handle->cancel();
+        runButton->setEnabled(false);
+        return;
+    }
+    start();
+}
+
+void WorkerBoardsPanel::start() {
+    int n = sizeSpin->value();
+    int threads = threadSpin->value();
+    monitor.reset(new Core::WorkerMonitor(threads));
+    monitor->reset(n);
+    rebuildBoards(threads, n);
+
+    Core::SearchOptions options;
+    options.threads = threads;
+    options.workers = monitor.get();
+    handle.reset(new Core::SearchHandle(Core::searchAsync(n, options)));
+
+    runButton->setText("取消");
+    sizeSpin->setEnabled(false);
+    threadSpin->setEnabled(false);
+    summaryLabel->setText(QString("N=%1 并行计数中 (%2 线程)").arg(n).arg(threads));
+    sampleTimer->start();
+}
+
+void WorkerBoardsPanel::finish() {
+    sampleTimer->stop();
+    Core::SearchResult result = handle->get();
+    handle.reset();
+    sampleWorkers();
+
+    runButton->setText("并行计数");
+    runButton->setEnabled(true);
+    sizeSpin->setEnabled(true);
+    threadSpin->setEnabled(true);
+    QString text = QString("N=%1 共 %2 个解，%3 个节点，耗时 %4 秒")
+                       .arg(sizeSpin->value()).arg(qulonglong(result.solutions)).arg(qulonglong(result.nodes))
+                       .arg(result.elapsedSeconds, 0, 'f', 2);
+    if (result.partial) text += QString(" [部分结果: %1]").arg(Core::runStatusName(result.status));
+    summaryLabel->setText(text);
+}
+
+void WorkerBoardsPanel::rebuildBoards(int workers, int n) {
+    QGridLayout *grid = static_cast<QGridLayout *>(boardsArea->layout());
+    for (ChessboardWidget *board : boards) delete board;
+    for (QLabel *label : boardLabels) delete label;
+    boards.clear();
+    boardLabels.clear();
+    lastVersions.assign(workers, 0);
+
+    int columns = std::max(1, int(std::ceil(std::sqrt(double(workers)))));
+    for (int w = 0; w < workers; ++w) {
+        ChessboardWidget *board = new ChessboardWidget(n);
+        board->setMinimumSize(MINI_BOARD_SIZE, MINI_BOARD_SIZE);
+        board->setAnimationSpeed(1);
+        QLabel *label = new QLabel(QString("线程 %1").arg(w));
+        label->setAlignment(Qt::AlignCenter);
+        grid->addWidget(board, (w / columns) * 2, w % columns);
+        grid->addWidget(label, (w / columns) * 2 + 1, w % columns);
+        boards.push_back(board);
+        boardLabels.push_back(label);
+    }
+}
+
+void WorkerBoardsPanel::sampleWorkers() {
+    if (!monitor) return;
+    for (int w = 0; w < (int)boards.size(); ++w) {
+        // 版本号未变说明该线程没有发布新状态，跳过重绘
+        uint32_t version = monitor->version(w);
+        if (version == lastVersions[w]) continue;
+        Core::WorkerSnapshot snapshot;
+        if (!monitor->sample(w, snapshot)) continue;
+        lastVersions[w] = version;
+
+        std::vector<int> queens(snapshot.n, -1);
+        for (int r = 0; r < snapshot.depth && r < snapshot.n; ++r) queens[r] = snapshot.queens[r];
+        boards[w]->setQueensManually(queens);
+        boardLabels[w]->setText(QString("线程 %1%2\n节点 %3  解 %4  单元 %5")
+                                    .arg(w).arg(snapshot.active ? "" : " (空闲)")
+                                    .arg(qulonglong(snapshot.nodes)).arg(qulonglong(snapshot.solutions))
+                                    .arg(snapshot.unitsDone));
+    }
+    if (handle && handle->isReady()) finish();
+}
+
+} // namespace UI
+} // namespace NQueens
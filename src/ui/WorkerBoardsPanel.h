@@ -0,0 +1,49 @@
+#pragma once
+#include <QWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+#include "core/AsyncSolver.h"
+#include "core/WorkerMonitor.h"
+#include "ui/ChessboardWidget.h"
+
+namespace NQueens {
+	namespace UI {
+
+		// 并行计数的实时视图：每个工作线程一块小棋盘，按帧率无锁采样各线程发布的部分棋盘与计数
+		class WorkerBoardsPanel : public QWidget {
+			Q_OBJECT
+
+		public:
+			explicit WorkerBoardsPanel(QWidget *parent = nullptr);
+			~WorkerBoardsPanel() override;
+
+		private slots:
+			void toggleRun();
+			void sampleWorkers();
+
+		private:
+			void start();
+			void finish();
+			void rebuildBoards(int workers, int n);
+
+			QSpinBox *sizeSpin;
+			QSpinBox *threadSpin;
+			QPushButton *runButton;
+			QLabel *summaryLabel;
+			QWidget *boardsArea;
+			std::vector<ChessboardWidget *> boards;
+			std::vector<QLabel *> boardLabels;
+			std::vector<uint32_t> lastVersions;
+
+			QTimer *sampleTimer;
+			std::unique_ptr<Core::WorkerMonitor> monitor;
+			std::unique_ptr<Core::SearchHandle> handle;
+		};
+
+	} // namespace UI
+} // namespace NQueens
@@ -0,0 +1,549 @@
+// nqueens_core 与命令行校验器的回归测试：各计数引擎与已知解数、穷举结果交叉校验。
+// 用法: nqueens-tests [用例名]，不带参数时运行全部用例；有失败时返回 1
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cli/BulkValidator.h"
+#include "core/FirstSolution.h"
+#include "core/MeetInMiddleCounter.h"
+#include "core/NQueensCounter.h"
+#include "core/PackedSolutions.h"
+#include "core/QueryProtocol.h"
+#include "core/RectangularCounter.h"
+#include "core/RoaringBitmap.h"
+#include "core/Sampler.h"
+#include "core/SolutionBitmapIndex.h"
+#include "core/SolutionDag.h"
+#include "core/SolutionIndex.h"
+#include "core/SolutionStream.h"
+#include "core/VariantCounter.h"
+
+using namespace NQueens;
+
+namespace {
+
+using Board = std::vector<int>;
+
+// N=0..12 的 N 皇后解数
+const uint64_t KNOWN_COUNTS[] = {1, 1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200};
+const int MAX_KNOWN = 12;
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+    if (ok) return;
+    ++failures;
+    std::cerr << "失败: " << what << '\n';
+}
+
+void checkEqual(uint64_t actual, uint64_t expected, const std::string &what) {
+    check(actual == expected, what + "：得到 " + std::to_string(actual) + "，应为 " + std::to_string(expected));
+}
+
+template <typename E, typename F>
+void checkThrows(F &&f, const std::string &what) {
+    try {
+        f();
+    } catch (const E &) {
+        return;
+    }
+    check(false, what + "：没有抛出异常");
+}
+
+std::string boardText(const Board &queens) {
+    std::string text;
+    for (size_t r = 0; r < queens.size(); ++r) text += (r ? " " : "") + std::to_string(queens[r]);
+    return text;
+}
+
+// 每行放一个棋子的回溯穷举，按字典序输出；attacks 判断两个棋子是否互相攻击
+using AttackRule = std::function<bool(int r1, int c1, int r2, int c2)>;
+
+void bruteForce(int n, const AttackRule &attacks, int row, Board &queens, std::vector<Board> &out) {
+    if (row == n) {
+        out.push_back(queens);
+        return;
+    }
+    for (int c = 0; c < n; ++c) {
+        bool ok = true;
+        for (int r = 0; r < row && ok; ++r) ok = !attacks(r, queens[r], row, c);
+        if (!ok) continue;
+        queens[row] = c;
+        bruteForce(n, attacks, row + 1, queens, out);
+    }
+}
+
+std::vector<Board> bruteForce(int n, const AttackRule &attacks) {
+    std::vector<Board> out;
+    Board queens(n);
+    bruteForce(n, attacks, 0, queens, out);
+    return out;
+}
+
+bool queensAttack(int r1, int c1, int r2, int c2) {
+    return c1 == c2 || r1 - c1 == r2 - c2 || r1 + c1 == r2 + c2;
+}
+
+std::vector<Board> allSolutions(int n) {
+    return bruteForce(n, queensAttack);
+}
+
+bool matches(const Board &queens, const std::vector<int> &fixed) {
+    for (size_t r = 0; r < fixed.size(); ++r)
+        if (fixed[r] >= 0 && queens[r] != fixed[r]) return false;
+    return true;
+}
+
+uint64_t countMatching(const std::vector<Board> &solutions, const std::vector<int> &fixed) {
+    return std::count_if(solutions.begin(), solutions.end(), [&](const Board &b) { return matches(b, fixed); });
+}
+
+// 随机固定 1~3 行的皇后（可能互相冲突，此时应得 0）
+std::vector<int> randomFixed(int n, std::mt19937_64 &rng) {
+    std::vector<int> fixed(n, -1);
+    int rows = 1 + (int)(rng() % 3);
+    for (int i = 0; i < rows; ++i) fixed[rng() % n] = (int)(rng() % n);
+    return fixed;
+}
+
+std::string fixedText(int n, const std::vector<int> &fixed) {
+    return "N=" + std::to_string(n) + " 固定 [" + boardText(fixed) + "]";
+}
+
+void testCounts() {
+    for (int n = 1; n <= MAX_KNOWN; ++n) {
+        std::string name = "N=" + std::to_string(n);
+        checkEqual(Core::NQueensCounter(n, 0).count().solutions, KNOWN_COUNTS[n], name + " 逐行搜索");
+        checkEqual(Core::NQueensCounter(n, 2).count().solutions, KNOWN_COUNTS[n], name + " 两行残局表");
+        checkEqual(Core::NQueensCounter(n, 3).count().solutions, KNOWN_COUNTS[n], name + " 三行残局表");
+        checkEqual(Core::NQueensCounter(n).count(4).solutions, KNOWN_COUNTS[n], name + " 4 线程");
+        checkEqual(Core::MeetInMiddleCounter(n).count().solutions, KNOWN_COUNTS[n], name + " 折半计数");
+
+        Core::SearchOptions options;
+        options.threads = 2;
+        Core::SearchResult result = Core::NQueensCounter(n).search(options);
+        check(result.status == Core::RunStatus::Completed && !result.partial, name + " 受控计数未完成");
+        checkEqual(result.solutions, KNOWN_COUNTS[n], name + " 受控计数");
+    }
+
+    // 内存预算极小时各分区写入磁盘，结果应不变
+    Core::MeetInMiddleOptions spill;
+    spill.threads = 2;
+    spill.partitions = 4;
+    spill.memoryBudget = 1;
+    Core::MeetInMiddleStats stats;
+    checkEqual(Core::MeetInMiddleCounter(MAX_KNOWN, spill).count(nullptr, &stats).solutions, KNOWN_COUNTS[MAX_KNOWN],
+               "N=12 折半计数（溢出到磁盘）");
+    check(stats.spilled, "N=12 折半计数没有溢出到磁盘");
+
+    // 节点预算耗尽时返回部分结果；预算按工作单元内的节流间隔检查，N 要足够大单元才会超过间隔
+    Core::SearchOptions limited;
+    limited.budget.maxNodes = 1000;
+    Core::SearchResult partial = Core::NQueensCounter(16).search(limited);
+    check(partial.status == Core::RunStatus::NodeLimit && partial.partial, "N=16 节点预算没有生效");
+    check(partial.solutions < 14772512, "N=16 部分结果不应包含全部解");
+}
+
+void testEnumerate() {
+    for (int n = 1; n <= 9; ++n) {
+        std::string name = "N=" + std::to_string(n);
+        std::vector<Board> serial, parallel, streamed;
+        Core::NQueensCounter counter(n);
+        checkEqual(counter.enumerate([&](const Board &b) { serial.push_back(b); }), KNOWN_COUNTS[n], name + " 枚举");
+        counter.enumerate([&](const Board &b) { parallel.push_back(b); }, 3, 2);
+        for (const Board &b : Core::solutionStream(n)) streamed.push_back(b);
+        check(parallel == serial, name + " 并行枚举的顺序与单线程不同");
+        check(streamed == serial, name + " 生成器的顺序与枚举不同");
+
+        std::sort(serial.begin(), serial.end());
+        check(serial == allSolutions(n), name + " 枚举结果与穷举不同");
+    }
+}
+
+void testConstrained() {
+    std::mt19937_64 rng(26);
+    for (int n = 4; n <= 9; ++n) {
+        std::vector<Board> solutions = allSolutions(n);
+        for (int t = 0; t < 40; ++t) {
+            std::vector<int> fixed = randomFixed(n, rng);
+            uint64_t expected = countMatching(solutions, fixed);
+            for (int depth : {0, 2, 3}) {
+                std::string name = fixedText(n, fixed) + " 残局 " + std::to_string(depth);
+                checkEqual(Core::NQueensCounter(n, fixed, depth).count().solutions, expected, name);
+                checkEqual(Core::NQueensCounter(n, fixed, depth).count(3).solutions, expected, name + " 3 线程");
+            }
+        }
+    }
+    checkThrows<std::invalid_argument>([] { Core::NQueensCounter(8, std::vector<int>(7, -1)); }, "约束行数不符");
+    checkThrows<std::invalid_argument>([] { Core::NQueensCounter(8, std::vector<int>(8, 8)); }, "约束列号越界");
+}
+
+void testRank() {
+    for (int n = 1; n <= 9; ++n) {
+        std::string name = "N=" + std::to_string(n);
+        std::vector<Board> solutions = allSolutions(n);
+        Core::SolutionIndex index(n);
+        checkEqual(index.total(), solutions.size(), name + " 总解数");
+        for (uint64_t k = 0; k < solutions.size(); ++k) {
+            Board queens = index.unrank(k);
+            check(queens == solutions[k], name + " unrank(" + std::to_string(k) + ") = " + boardText(queens));
+            checkEqual(index.rank(solutions[k]), k, name + " rank(" + boardText(solutions[k]) + ")");
+        }
+        checkThrows<std::out_of_range>([&] { index.unrank(solutions.size()); }, name + " unrank 越界");
+    }
+
+    // 预热后的结果应与逐次计数相同
+    Core::SolutionIndex warm(10);
+    warm.warmUp(3, 2);
+    std::vector<Board> solutions = allSolutions(10);
+    for (uint64_t k = 0; k < solutions.size(); k += 7) {
+        check(warm.unrank(k) == solutions[k], "N=10 预热后 unrank(" + std::to_string(k) + ")");
+        checkEqual(warm.rank(solutions[k]), k, "N=10 预热后 rank");
+    }
+    checkThrows<std::invalid_argument>([&] { warm.rank({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}); }, "rank 非法解");
+}
+
+void testDag() {
+    std::mt19937_64 rng(40);
+    for (int n = 1; n <= 10; ++n) {
+        std::string name = "N=" + std::to_string(n);
+        std::vector<Board> solutions = allSolutions(n);
+        Core::SolutionDag dag(n);
+        checkEqual(dag.size(), solutions.size(), name + " DAG 解数");
+
+        std::vector<Board> visited;
+        dag.forEach([&](const Board &b) { visited.push_back(b); });
+        check(visited == solutions, name + " DAG 的迭代顺序不是字典序");
+        for (uint64_t k = 0; k < solutions.size(); ++k) {
+            check(dag.at(k) == solutions[k], name + " DAG at(" + std::to_string(k) + ")");
+            check(dag.contains(solutions[k]), name + " DAG 不包含 " + boardText(solutions[k]));
+        }
+        checkThrows<std::out_of_range>([&] { dag.at(solutions.size()); }, name + " DAG at 越界");
+
+        Board shifted(n);
+        for (int r = 0; r < n; ++r) shifted[r] = r;
+        check(n == 1 || !dag.contains(shifted), name + " DAG 包含非法解");
+
+        for (int t = 0; t < 40 && n >= 4; ++t) {
+            std::vector<int> fixed = randomFixed(n, rng);
+            checkEqual(dag.count(fixed), Core::NQueensCounter(n, fixed).count().solutions, fixedText(n, fixed) + " DAG 计数");
+        }
+    }
+}
+
+void testBitmapIndex() {
+    std::mt19937_64 rng(50);
+    for (int n = 4; n <= 10; ++n) {
+        Core::PackedSolutions packed(n);
+        Core::NQueensCounter(n).enumerate([&](const Board &b) { packed.append(b); });
+        Core::SolutionBitmapIndex index(packed);
+        checkEqual(index.size(), KNOWN_COUNTS[n], "N=" + std::to_string(n) + " 位图索引解数");
+        checkEqual(index.query({}).cardinality(), KNOWN_COUNTS[n], "N=" + std::to_string(n) + " 位图索引全集");
+
+        for (int t = 0; t < 40; ++t) {
+            std::vector<int> fixed = randomFixed(n, rng);
+            std::string name = fixedText(n, fixed) + " 位图查询";
+            Core::RoaringBitmap hits = index.query(fixed);
+            checkEqual(hits.cardinality(), Core::NQueensCounter(n, fixed).count().solutions, name);
+            hits.forEach([&](uint32_t id) {
+                check(matches(packed.at(id), fixed), name + " 命中不满足约束的解 " + boardText(packed.at(id)));
+                return true;
+            });
+        }
+    }
+}
+
+void testRoaring() {
+    // 同时覆盖数组与位图两种容器，以及跨桶的求交
+    std::mt19937_64 rng(50);
+    std::set<uint32_t> a, b;
+    for (int i = 0; i < 3000; ++i) a.insert((uint32_t)(rng() % 70000));
+    for (uint32_t v = 0; v < 140000; v += 3) b.insert(v);
+    Core::RoaringBitmap ra, rb;
+    for (uint32_t v : a) ra.append(v);
+    for (uint32_t v : b) rb.append(v);
+    checkEqual(ra.cardinality(), a.size(), "数组容器基数");
+    checkEqual(rb.cardinality(), b.size(), "位图容器基数");
+
+    std::vector<uint32_t> expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    check((ra & rb).values() == expected, "数组与位图求交");
+    check((rb & ra).values() == expected, "位图与数组求交");
+    check((rb & Core::RoaringBitmap::range(100000)).cardinality() == (100000 + 2) / 3, "位图与全集求交");
+    check(ra.contains(*a.begin()) && !ra.contains(70000), "成员判断");
+    checkThrows<std::invalid_argument>([&] { ra.append(0); }, "追加非递增值");
+}
+
+void testRectangular() {
+    for (int rows = 1; rows <= 5; ++rows) {
+        for (int cols = 1; cols <= 6; ++cols) {
+            for (int k = 0; k <= std::min(rows, cols); ++k) {
+                std::string name = std::to_string(rows) + "x" + std::to_string(cols) + " k=" + std::to_string(k);
+                uint64_t expected = Core::RectangularCounter::bruteForce(rows, cols, k);
+                checkEqual(Core::RectangularCounter(rows, cols, k).count().solutions, expected, name);
+                checkEqual(Core::RectangularCounter(rows, cols, k).count(3).solutions, expected, name + " 3 线程");
+            }
+        }
+    }
+    // 方盘上放 N 个皇后即 N 皇后问题
+    for (int n = 1; n <= 10; ++n)
+        checkEqual(Core::RectangularCounter(n, n, n).count(2).solutions, KNOWN_COUNTS[n], "方盘 N=" + std::to_string(n));
+    checkThrows<std::invalid_argument>([] { Core::RectangularCounter(3, 3, -1); }, "皇后数为负");
+}
+
+void testVariants() {
+    for (int n = 1; n <= 8; ++n) {
+        std::vector<std::pair<Core::Variant, AttackRule>> rules = {
+            {Core::Variant::Queens, queensAttack},
+            {Core::Variant::Toroidal,
+             [n](int r1, int c1, int r2, int c2) {
+                 return c1 == c2 || (r1 - c1 - r2 + c2 + 2 * n) % n == 0 || (r1 + c1 - r2 - c2 + 2 * n) % n == 0;
+             }},
+            {Core::Variant::Superqueens,
+             [](int r1, int c1, int r2, int c2) {
+                 int dr = std::abs(r1 - r2), dc = std::abs(c1 - c2);
+                 return queensAttack(r1, c1, r2, c2) || (dr == 1 && dc == 2) || (dr == 2 && dc == 1);
+             }},
+            {Core::Variant::Rooks, [](int, int c1, int, int c2) { return c1 == c2; }},
+            {Core::Variant::Bishops,
+             [](int r1, int c1, int r2, int c2) { return std::abs(r1 - r2) == std::abs(c1 - c2); }},
+        };
+        for (const auto &rule : rules) {
+            std::string name = std::string(Core::variantName(rule.first)) + " N=" + std::to_string(n);
+            uint64_t expected = bruteForce(n, rule.second).size();
+            checkEqual(Core::VariantCounter(n, rule.first).count().solutions, expected, name);
+            checkEqual(Core::VariantCounter(n, rule.first).count(3).solutions, expected, name + " 3 线程");
+        }
+    }
+
+    // 穷举太慢的几个已知值（OEIS A051906、A051223）
+    checkEqual(Core::VariantCounter(11, Core::Variant::Toroidal).count(2).solutions, 88, "toroidal N=11");
+    checkEqual(Core::VariantCounter(13, Core::Variant::Toroidal).count(2).solutions, 4524, "toroidal N=13");
+    checkEqual(Core::VariantCounter(10, Core::Variant::Superqueens).count(2).solutions, 4, "superqueens N=10");
+    checkEqual(Core::VariantCounter(12, Core::Variant::Superqueens).count(2).solutions, 156, "superqueens N=12");
+    checkEqual(Core::VariantCounter(10, Core::Variant::Rooks).count(2).solutions, 3628800, "rooks N=10");
+    check(Core::parseVariant("superqueens") == Core::Variant::Superqueens, "解析变体名");
+    checkThrows<std::invalid_argument>([] { Core::parseVariant("knights"); }, "未知变体名");
+}
+
+void testOccupancy() {
+    for (int n = 1; n <= 9; ++n) {
+        std::vector<Board> solutions = allSolutions(n);
+        Core::OccupancyMap map = Core::NQueensCounter(n).occupancy(2);
+        checkEqual(map.solutions, solutions.size(), "N=" + std::to_string(n) + " 占用统计解数");
+        std::vector<uint64_t> expected((size_t)n * n, 0);
+        for (const Board &b : solutions)
+            for (int r = 0; r < n; ++r) expected[(size_t)r * n + b[r]]++;
+        check(map.cells == expected, "N=" + std::to_string(n) + " 逐格占用次数与穷举不同");
+    }
+}
+
+void testSampler() {
+    std::vector<Board> solutions = allSolutions(6);
+    std::set<Board> valid(solutions.begin(), solutions.end()), seen;
+    Core::SamplerOptions options;
+    options.seed = 39;
+    Core::Sampler exact(6, options);
+    checkEqual(exact.total(), solutions.size(), "N=6 精确采样总解数");
+    for (int i = 0; i < 200; ++i) {
+        Board b = exact.next();
+        check(valid.count(b) == 1, "N=6 精确采样得到非法解 " + boardText(b));
+        seen.insert(b);
+    }
+    checkEqual(seen.size(), solutions.size(), "N=6 精确采样没有覆盖全部解");
+
+    solutions = allSolutions(10);
+    valid = std::set<Board>(solutions.begin(), solutions.end());
+    options.approximate = true;
+    options.exactRows = 4;
+    Core::Sampler approximate(10, options);
+    for (int i = 0; i < 200; ++i) {
+        Board b = approximate.next();
+        check(valid.count(b) == 1, "N=10 近似采样得到非法解 " + boardText(b));
+    }
+    checkThrows<std::runtime_error>([] { Core::Sampler(3).next(); }, "N=3 无解时采样");
+}
+
+bool isSolution(const Board &queens) {
+    int n = (int)queens.size();
+    for (int r = 0; r < n; ++r) {
+        if (queens[r] < 0 || queens[r] >= n) return false;
+        for (int s = 0; s < r; ++s)
+            if (queensAttack(s, queens[s], r, queens[r])) return false;
+    }
+    return true;
+}
+
+void testFirstSolution() {
+    for (Core::ValueOrder order : {Core::ValueOrder::Lexicographic, Core::ValueOrder::CenterOut,
+                                   Core::ValueOrder::LeastConstraining}) {
+        for (int n : {1, 2, 3, 4, 5, 8, 13, 32, 100, 200}) {
+            std::string name = std::string(Core::valueOrderName(order)) + " N=" + std::to_string(n);
+            if (order == Core::ValueOrder::Lexicographic && n > 32) continue;  // 字典序不重启，大 N 太慢
+            Core::FirstSolutionOptions options;
+            options.order = order;
+            options.seed = 48;
+            Core::FirstSolutionResult result = Core::FirstSolutionSearch(n, options).run();
+            check(result.status == Core::RunStatus::Completed, name + " 没有搜索完");
+            check(result.found == (n != 2 && n != 3), name + (result.found ? " 找到了不存在的解" : " 没有找到解"));
+            if (result.found) check(isSolution(result.queens), name + " 给出非法解 " + boardText(result.queens));
+        }
+    }
+}
+
+void testProtocol() {
+    Core::QueryRequest count;
+    count.op = Core::QueryOp::Count;
+    count.n = 9;
+    count.fixed = {-1, 3, -1, -1, -1, -1, -1, 0, -1};
+    Core::QueryRequest decoded = Core::decodeRequest(Core::encodeRequest(count));
+    check(decoded.op == count.op && decoded.n == count.n && decoded.fixed == count.fixed, "Count 请求编解码");
+
+    Core::QueryRequest rank;
+    rank.op = Core::QueryOp::Rank;
+    rank.n = 4;
+    rank.queens = {1, 3, 0, 2};
+    decoded = Core::decodeRequest(Core::encodeRequest(rank));
+    check(decoded.op == rank.op && decoded.queens == rank.queens, "Rank 请求编解码");
+
+    Core::QueryRequest unrank;
+    unrank.op = Core::QueryOp::Enumerate;
+    unrank.n = 4;
+    unrank.index = 1;
+    unrank.count = 2;
+    Core::QueryResponse response;
+    response.boards = {{1, 3, 0, 2}, {2, 0, 3, 1}};
+    Core::QueryResponse back = Core::decodeResponse(unrank, Core::encodeResponse(unrank, response));
+    check(back.ok && back.boards == response.boards, "Enumerate 应答编解码");
+
+    Core::QueryResponse error;
+    error.ok = false;
+    error.error = "计算已取消";
+    back = Core::decodeResponse(unrank, Core::encodeResponse(unrank, error));
+    check(!back.ok && back.error == error.error, "错误应答编解码");
+
+    checkThrows<std::invalid_argument>([] { Core::decodeRequest(std::string("\x07\x01\x08", 3)); }, "未知协议版本");
+}
+
+Cli::ValidationReport validate(const std::string &text, Cli::ValidateOptions options) {
+    std::FILE *in = std::tmpfile();
+    if (!in) throw std::runtime_error("无法创建临时文件");
+    std::fwrite(text.data(), 1, text.size(), in);
+    std::rewind(in);
+    try {
+        Cli::ValidationReport report = Cli::validateSolutions(in, options);
+        std::fclose(in);
+        return report;
+    } catch (...) {
+        std::fclose(in);
+        throw;
+    }
+}
+
+void testValidator() {
+    std::string all;
+    for (const Board &b : allSolutions(8)) all += boardText(b) + '\n';
+    for (int threads : {1, 4}) {
+        Cli::ValidateOptions options;
+        options.threads = threads;
+        options.blockSize = 64;  // 很小的块，覆盖跨块的行
+        options.duplicates = true;
+        Cli::ValidationReport report = validate(all + "\n", options);
+        check(report.ok(), "N=8 全部解应通过校验");
+        checkEqual(report.n, 8, "自动识别棋盘大小");
+        checkEqual(report.records, 92, "N=8 记录数");
+
+        report = validate(all + "0 4 7 5 2 6 1 3\n", options);
+        checkEqual(report.duplicates, 1, "重复记录");
+        checkEqual(report.firstDuplicate.line, 93, "重复记录的行号");
+    }
+
+    Cli::ValidateOptions options;
+    options.n = 4;
+    struct Case {
+        const char *text;
+        bool valid;
+    } cases[] = {
+        {"1 3 0 2", true},
+        {"2 0 3 1", true},
+        {"0 1 2 3", false},   // 对角线
+        {"1 3 0 0", false},   // 同列
+        {"1 3 0 4", false},   // 越界
+        {"1 3 0", false},     // 列数不符
+        {"1 3 x 2", false},   // 非数字
+    };
+    for (const Case &c : cases) {
+        Cli::ValidationReport report = validate(std::string(c.text) + '\n', options);
+        check(report.ok() == c.valid, std::string("校验 \"") + c.text + "\" 应" + (c.valid ? "通过" : "拒绝"));
+    }
+
+    options.format = Cli::OutputFormat::Csv;
+    check(validate("4,1,3,0,2\n", options).ok(), "CSV 合法记录");
+    check(!validate("5,1,3,0,2\n", options).ok(), "CSV 声明的 N 不符");
+    options.format = Cli::OutputFormat::Json;
+    check(validate("{\"n\":4,\"queens\":[2,0,3,1]}\n", options).ok(), "JSON 合法记录");
+    check(!validate("{\"n\":4,\"queens\":[2,0,3]}\n", options).ok(), "JSON 列数不符");
+
+    options.format = Cli::OutputFormat::Text;
+    options.canonical = true;
+    Cli::ValidationReport report = validate("1 3 0 2\n2 0 3 1\n", options);
+    checkEqual(report.nonCanonical, 1, "非规范解（镜像）");
+    checkEqual(report.firstNonCanonical.line, 2, "非规范解的行号");
+
+    std::string wide;
+    for (int c = 0; c < 33; ++c) wide += (c ? " " : "") + std::to_string(c);
+    checkThrows<std::runtime_error>([&] { validate(wide + '\n', Cli::ValidateOptions()); }, "超过 31 列的记录");
+}
+
+struct TestCase {
+    const char *name;
+    void (*run)();
+};
+
+const TestCase TESTS[] = {
+    {"counts", testCounts},
+    {"enumerate", testEnumerate},
+    {"constrained", testConstrained},
+    {"rank", testRank},
+    {"dag", testDag},
+    {"bitmap-index", testBitmapIndex},
+    {"roaring", testRoaring},
+    {"rectangular", testRectangular},
+    {"variants", testVariants},
+    {"occupancy", testOccupancy},
+    {"sampler", testSampler},
+    {"first-solution", testFirstSolution},
+    {"protocol", testProtocol},
+    {"validator", testValidator},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string only = argc > 1 ? argv[1] : "";
+    bool found = false;
+    for (const TestCase &test : TESTS) {
+        if (!only.empty() && only != test.name) continue;
+        found = true;
+        int before = failures;
+        try {
+            test.run();
+        } catch (const std::exception &e) {
+            check(false, std::string("未预期的异常: ") + e.what());
+        }
+        std::cout << (failures == before ? "通过 " : "失败 ") << test.name << '\n';
+    }
+    if (!found) {
+        std::cerr << "未知用例: " << only << '\n';
+        return 2;
+    }
+    return failures ? 1 : 0;
+}